@@ -2,150 +2,121 @@
  * gcov lines checker
  * (author murata.muu@gmail.com)
  * 2009.12.22 new
- * 2010.01.28 deleteのみの差分ソースは無視
- * 2010.01.29 diffall fmt
- * 2010.04.05 ファイル名Index:のみでdiffの実体がない場合は対象外
- * 2010.05.31 .gcov.diff を作成しない
- *            svn diff フォーマットに対応
- *            diffファイルフォーマット自動選択
- *            default diffファイル名を追加
- *            gcov timestamp チェック
- * 2011.02.10 c1 branch coverageに対応
+ * 2026.10.18 解析処理を libdiffgcov に分離, コマンドは option 解析, gcov 更新の確認と report 出力
  */
 
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
-#include <sys/types.h>
-#include <sys/stat.h>
 #include <ctype.h>
+#include <unistd.h>
+#include "libdiffgcov_int.h" /* 20261018 */
 
 #define DEFAULT_DIFF_FILENAME "diff.txt"
-#define LINEBUFSZ 1024
-#define FILENAMESZ 256
-#define GCOV_COMMAND "/usr/bin/gcov"
-
-enum _diff_fmt {
-    UNKNOWN_FMT, /* 20100531 */
-    CVS_FMT,
-    DIFF_FMT,
-    SVN_FMT,     /* 20100531 */
-};
-
-enum _gcov_level { /* 20110210 */
-    UNKNOWN_LEVEL,
-    C0_LINE_LEVEL,
-    C1_BRANCH_LEVEL,
-};
+#define HOT_DEFAULT_TOP 10                /* --hot (20261018) */
 
 /**
  * structure define
  */
-struct _line_data {
-    int start;
-    int end;
-    struct _line_data *next;
-};
-typedef struct _line_data LINE_DATA;
-
-struct _diff_data {
-    char src[FILENAMESZ];
-    LINE_DATA *line;
-    struct _diff_data *next;
-};
-typedef struct _diff_data DIFF_DATA;
-
-struct _gcov_line_buf {
-    char *top;
-    unsigned long max;
-    unsigned long pos;
-    unsigned long refpos;
+struct _option {
+    int diff_fmt;
+    char *file;
+    int level; /* 20110210 */
+    int jobs;  /* 20261018 */
+    int pipe;  /* 20261018 */
+    int stream; /* 20261018 */
+    char *remap; /* 20261018 */
+    char *index; /* 20261018 */
+    char *index_test;
+    int hot;     /* 20261018 */
+    char *partial; /* 20261018 */
+    char **merge;  /* 20261018 */
+    int nmerge;
+    int rollup;  /* 20261018 */
+    int rollup_depth;
+    int stamp;   /* 20261018 */
+    int inst;    /* 20261018 */
+    char *server; /* 20261018 */
 };
-typedef struct _gcov_line_buf GCOV_LINE_BUF; /* 20100531 */
+typedef struct _option OPTION;
 
-struct _gcov_branch_data {
-    int s_pos;
-    int e_pos;
-    struct _gcov_branch_data *next;
+struct _hot_line {
+    char gcov[FILENAMESZ];
+    char text[LINEBUFSZ];
+    char taken[64];           /* branch taken % */
+    unsigned long long count;
 };
-typedef struct _gcov_branch_data GCOV_BRANCH_DATA; /* 20110210 */
+typedef struct _hot_line HOT_LINE; /* 20261018 */
 
-struct _gcov_line_data {
-    int s_pos;
-    int e_pos;
-    GCOV_BRANCH_DATA *branch;
-    int branch_pass;
-    int branch_notpass;
-    struct _gcov_line_data *next;
+struct _hot_rank {
+    int top;
+    int n;
+    HOT_LINE *line;           /* sorted by count (descending) */
+    HOT_LINE *work;           /* ranking of one file (20261018) */
 };
-typedef struct _gcov_line_data GCOV_LINE_DATA; /* 20110210 */
+typedef struct _hot_rank HOT_RANK; /* 20261018 */
 
-struct _gcov_data {
-    char gcov[FILENAMESZ];
-    GCOV_LINE_BUF linebuf;
-    GCOV_LINE_DATA *line; /* 20110210 */
-    double line_parcent;
-    double branch_parcent; /* 20110210 */
+struct _rollup {
+    char name[FILENAMESZ];    /* path prefix, ex) "src/lib/" */
+    int depth;                /* 0: root (total) */
     int line_pass;
     int line_notpass;
-    int branch_pass; /* 20110210 */
+    int branch_pass;
     int branch_notpass;
-    struct _gcov_data *next;
+    int func_pass;            /* 20261018 */
+    int func_notpass;
+    int cond_pass;
+    int cond_notpass;
+    struct _rollup *child;    /* sorted by name */
+    struct _rollup *next;
 };
-typedef struct _gcov_data GCOV_DATA;
-
-struct _read_buf {
-    char prev[LINEBUFSZ];
-    char crnt[LINEBUFSZ];
-    char next[LINEBUFSZ];
+typedef struct _rollup ROLLUP; /* 20261018 */
+
+struct _report {
+    int level;
+    int started;              /* result head is printed */
+    HOT_RANK *hot;            /* --hot: total ranking */
+    FILE *partial;            /* --partial: output file */
+    ROLLUP *rollup;           /* --rollup: path prefix tree */
+    int inst;                 /* --instances */
 };
-typedef struct _read_buf READ_BUF;
-
-struct _option {
-    int diff_fmt;
-    char *file;
-    int level; /* 20110210 */
-};
-typedef struct _option OPTION;
+typedef struct _report REPORT; /* stream report state (20261018) */
 
 /**
  * local function
  */
-void create_diff_data(OPTION *opt, DIFF_DATA **top);
-void parse_diff_src(char *p, char *name, int fmt);
-void create_line_data(FILE *fp, READ_BUF *readbuf, LINE_DATA **top, int fmt);
-void parse_diff_lineno(char *line, int *start, int *end);
-void free_diff_data(DIFF_DATA *p);
-void free_line_data(LINE_DATA *p);
-void debug_print_diff_data(DIFF_DATA *diff);
-int readline(char *buf, READ_BUF *p, FILE *fp);
-void cut_LF(char *p);
-int is_start_diff_section(READ_BUF *p, int fmt);
-int is_end_diff_section(READ_BUF *p, int fmt);
-int is_diff_summary_line(READ_BUF *p, int fmt);
-void create_gcov_data(DIFF_DATA *diff, GCOV_DATA **top);
-void free_gcov_data(GCOV_DATA *p);
-void free_gcov_line_data(GCOV_LINE_DATA *p);
-void free_gcov_branch_data(GCOV_BRANCH_DATA *p);
-void calc_gcov(GCOV_DATA *p);
-void parcent(GCOV_DATA *p);
-void print_gcov(GCOV_DATA *p, int level);
-void print_notpass_line(GCOV_DATA *p, int level);
 int get_option(int argc, char **argv, OPTION *opt);
 void debug_print_option(OPTION *opt);
 void print_usage(char *cmd_name);
-int get_diff_format(char *filename);
-void create_line_data_for_svn(FILE *fp, READ_BUF *readbuf, LINE_DATA **top);
-int is_svndiff_summary(char *line);
-int is_svndiff_start(READ_BUF *p);
-int is_svndiff_end(READ_BUF *p);
-int get_svndiff_baseline(char *line);
-unsigned long gcov_line_data_copy(GCOV_LINE_BUF *p, char *data, unsigned long sz, unsigned long *s_pos, unsigned long *e_pos);
-int gcov_line_gets(GCOV_LINE_BUF *p, char *out, unsigned long outsz);
-int gcov_line_get_by_pos(GCOV_LINE_BUF *p, char *out, unsigned long outsz, unsigned long s_pos, unsigned long e_pos);
-void gcov_line_refreset(GCOV_LINE_BUF *p);
-int need_gcov_update(DIFF_DATA *diff);
-int gcov_update(int level);
+int run_report(OPTION *opt);
+int gcov_update(int level, int jobs, int stamp);
+void calc_gcov(GCOV_DATA *p, ROLLUP *rollup);
+void print_gcov(GCOV_DATA *p, int level);
+void print_gcov_result_head(void);
+void print_gcov_result(GCOV_DATA *p, int level);
+void print_gcov_summary(GCOV_DATA *p, int level);
+void report_gcov(void *arg, GCOV_DATA *p);
+void report_gcov_finish(REPORT *r, GCOV_DATA *top);
+void print_metric(const char *name, const char *metric, int pass, int notpass);
+int hot_rank_init(HOT_RANK *rank, int top);
+void hot_rank_free(HOT_RANK *rank);
+void hot_rank_add(HOT_RANK *rank, GCOV_DATA *p, GCOV_LINE_DATA *pl);
+void hot_rank_copy(HOT_RANK *rank, HOT_LINE *hl);
+int print_hot(GCOV_DATA *p, int top);
+void print_hot_head(void);
+void print_hot_gcov(GCOV_DATA *p, HOT_RANK *total);
+void print_hot_rank(HOT_RANK *rank, int with_name);
+void print_inst(GCOV_DATA *p);
+void print_inst_head(void);
+void print_inst_gcov(GCOV_DATA *p);
+void rollup_gcov(ROLLUP *root, GCOV_DATA *p);
+ROLLUP *get_rollup_child(ROLLUP *parent, char *name, unsigned long len);
+void print_rollup(ROLLUP *root, int level, int depth);
+void print_rollup_node(ROLLUP *p, int level, int depth);
+void free_rollup(ROLLUP *p);
+void print_unknown_line(GCOV_DATA *p);
+void print_notpass_line(GCOV_DATA *p, int level);
+void print_impact_test(TEST_INDEX *idx, DIFF_DATA *diff);
 
 /**
  * main
@@ -153,8 +124,7 @@ int gcov_update(int level);
 int main(int argc, char **argv)
 {
     OPTION opt;
-    DIFF_DATA *diff;
-    GCOV_DATA *gcov;
+    int ret;
 
     memset(&opt, 0, sizeof(opt));
     if (get_option(argc, argv, &opt) != 0) {
@@ -163,919 +133,885 @@ int main(int argc, char **argv)
     }
     /* debug_print_option(&opt); */
 
-    if (opt.diff_fmt == UNKNOWN_FMT) {
-        if ((opt.diff_fmt = get_diff_format(opt.file)) == UNKNOWN_FMT) { /* 20100531 */
-            print_usage(argv[0]);
-            return -1;
-        }
-    }
-
-    diff = NULL;
-    create_diff_data(&opt, &diff);
-    if (diff == NULL) return -1;
-    /* debug_print_diff_data(diff); */
-
-    if (need_gcov_update(diff)) {
-        if (gcov_update(opt.level) == 0) {
-            free_diff_data(diff);
-            return 0;
-        }
+    if ((ret = run_report(&opt)) == DGC_ERR_FORMAT) { /* 20100531 */
+        print_usage(argv[0]);
+        return -1;
     }
-
-    gcov = NULL;
-    create_gcov_data(diff, &gcov);
-    if (gcov == NULL) return -1;
-    calc_gcov(gcov);
-    print_gcov(gcov, opt.level);
-    free_gcov_data(gcov);
-
-    free_diff_data(diff);
-
-    return 0;
+    return ret;
 }
 
 /**
- * create diff data
+ * get command line option parameter
+ * 0: ok
+ * -1: err
  */
-void create_diff_data(OPTION *opt, DIFF_DATA **top)
+int get_option(int argc, char **argv, OPTION *opt)
 {
-    FILE *fp;
-    char linebuf[LINEBUFSZ];
-    READ_BUF readbuf;
-    DIFF_DATA *p, *p_prev;
-
-    if ((fp = fopen(opt->file, "r")) == NULL) return;
-
-    memset(&readbuf, 0, sizeof(readbuf));
-
-    while(1) {
-        memset(linebuf, 0, sizeof(linebuf));
-        if (readline(linebuf, &readbuf, fp) == -1) {fclose(fp); return;} /* eof */
-
-        if (is_start_diff_section(&readbuf, opt->diff_fmt)) {
-            if ((p = (DIFF_DATA *)malloc(sizeof(DIFF_DATA))) == NULL) continue;
-
-            memset(p, 0, sizeof(DIFF_DATA));
-            parse_diff_src(linebuf, p->src, opt->diff_fmt);
-
-            if (opt->diff_fmt == SVN_FMT) {
-                create_line_data_for_svn(fp, &readbuf, &p->line);
-            } else {
-                create_line_data(fp, &readbuf, &p->line, opt->diff_fmt);
-            }
-            if (p->line == NULL) { free(p); continue; } /* diff is only 'd' */
+    int i;
 
-            if (*top == NULL) {
-                *top = p;
-                p_prev = p;
+    opt->diff_fmt = DGC_UNKNOWN_FMT;
+    opt->file = (char *)DEFAULT_DIFF_FILENAME; /* 20100531 */
+    opt->level = DGC_C0_LINE_LEVEL;
+    opt->jobs = (int)sysconf(_SC_NPROCESSORS_ONLN); /* 20261018 */
+    if (opt->jobs < 1) opt->jobs = 1;
+    if (argc > 1) {
+        for (i = 1; i < argc; i++) {
+            if (!strcmp(argv[i], "-c0") || !strcmp(argv[i], "-C0")) {
+                opt->level = DGC_C0_LINE_LEVEL;
+            } else if (!strcmp(argv[i], "-c1") || !strcmp(argv[i], "-C1")) {
+                opt->level = DGC_C1_BRANCH_LEVEL;
+            } else if (!strcmp(argv[i], "-a") || !strcmp(argv[i], "--all")) { /* 20261018 */
+                opt->level = DGC_ALL_LEVEL;
+            } else if (!strcmp(argv[i], "-c") || !strcmp(argv[i], "--cvsdiff")) {
+                opt->diff_fmt = DGC_CVS_FMT;
+            } else if (!strcmp(argv[i], "-d") || !strcmp(argv[i], "--diffall")) {
+                opt->diff_fmt = DGC_DIFF_FMT;
+            } else if (!strcmp(argv[i], "-s") || !strcmp(argv[i], "--svndiff")) {
+                opt->diff_fmt = DGC_SVN_FMT;
+            } else if (!strcmp(argv[i], "-g") || !strcmp(argv[i], "--gitdiff")) { /* 20261018 */
+                opt->diff_fmt = DGC_GIT_FMT;
+            } else if (!strcmp(argv[i], "-p") || !strcmp(argv[i], "--pipe")) { /* 20261018 */
+                opt->pipe = 1;
+            } else if (!strcmp(argv[i], "--stream")) { /* 20261018 */
+                opt->stream = 1;
+            } else if (!strcmp(argv[i], "-r") || !strcmp(argv[i], "--remap")) { /* 20261018 */
+                if (i+1 >= argc) return -1;
+                opt->remap = argv[++i];
+            } else if (!strcmp(argv[i], "--index-add")) { /* 20261018 */
+                if (i+2 >= argc) return -1;
+                opt->index = argv[++i];
+                opt->index_test = argv[++i];
+            } else if (!strcmp(argv[i], "--impact")) { /* 20261018 */
+                if (i+1 >= argc) return -1;
+                opt->index = argv[++i];
+            } else if (!strcmp(argv[i], "--hot")) { /* 20261018 */
+                opt->hot = HOT_DEFAULT_TOP;
+                if (i+1 < argc && isdigit(argv[i+1][0]) && strspn(argv[i+1], "0123456789") == strlen(argv[i+1])) {
+                    opt->hot = atoi(argv[++i]);
+                    if (opt->hot < 1) return -1;
+                }
+            } else if (!strcmp(argv[i], "--rollup")) { /* 20261018 */
+                opt->rollup = 1;
+                if (i+1 < argc && isdigit(argv[i+1][0]) && strspn(argv[i+1], "0123456789") == strlen(argv[i+1])) {
+                    opt->rollup_depth = atoi(argv[++i]);
+                }
+            } else if (!strcmp(argv[i], "--stamp")) { /* 20261018 */
+                opt->stamp = 1;
+            } else if (!strcmp(argv[i], "--instances")) { /* 20261018 */
+                opt->inst = 1;
+            } else if (!strcmp(argv[i], "--server")) { /* 20261018 */
+                if (i+1 >= argc) return -1;
+                opt->server = argv[++i];
+            } else if (!strcmp(argv[i], "--partial")) { /* 20261018 */
+                if (i+1 >= argc) return -1;
+                opt->partial = argv[++i];
+            } else if (!strcmp(argv[i], "--merge")) { /* 20261018 */
+                opt->merge = &argv[i+1];
+                for (; i+1 < argc && argv[i+1][0] != '-'; i++) opt->nmerge++;
+                if (opt->nmerge == 0) return -1;
+            } else if (!strncmp(argv[i], "-j", 2)) { /* 20261018 */
+                if (argv[i][2] != '\0') opt->jobs = atoi(argv[i] + 2);
+                else if (i+1 < argc) opt->jobs = atoi(argv[++i]);
+                if (opt->jobs < 1) return -1;
             } else {
-                p_prev->next = p;
-                p_prev = p;
+                opt->file = argv[i];
             }
         }
     }
+    return 0;
 }
 
 /**
- * parse diff src name
- * ex Index: aaa.c -> aaa.c
+ * debug print command line option
  */
-void parse_diff_src(char *p, char *name, int fmt)
+void debug_print_option(OPTION *opt)
 {
-    if (fmt == CVS_FMT || fmt == SVN_FMT) {
-        if (p = strstr(p, "Index:")) {
-            p = p + strlen("Index:");
-            p++; /* space */
-            strcpy(name, p);
-        }
-    } else {
-        strcpy(name, p);
-    }
+    printf("fmt[%d] file[%s] level[%d] jobs[%d] pipe[%d] stream[%d] remap[%s] index[%s] test[%s] hot[%d] partial[%s] merge[%d] rollup[%d:%d] stamp[%d] inst[%d] server[%s]\n", opt->diff_fmt, opt->file, opt->level, opt->jobs, opt->pipe, opt->stream,
+        opt->remap ? opt->remap : "", opt->index ? opt->index : "", opt->index_test ? opt->index_test : "", opt->hot,
+        opt->partial ? opt->partial : "", opt->nmerge, opt->rollup, opt->rollup_depth, opt->stamp, opt->inst, opt->server ? opt->server : "");
 }
 
 /**
- * create line data
+ * print out command usage
  */
-void create_line_data(FILE *fp, READ_BUF *readbuf, LINE_DATA **top, int fmt)
+void print_usage(char *cmd_name)
 {
-    char linebuf[LINEBUFSZ];
-    LINE_DATA *p, *p_prev;
-
-    while(1) {
-        if (is_end_diff_section(readbuf, fmt)) return; /* add murata 20100405 */
-
-        memset(linebuf, 0, sizeof(linebuf));
-        if (readline(linebuf, readbuf, fp) == -1) return; /* eof */
-
-        if (isdigit(linebuf[0])) {
-            if ((p = (LINE_DATA *)malloc(sizeof(LINE_DATA))) == NULL) continue;
-
-            memset(p, 0, sizeof(LINE_DATA));
-            parse_diff_lineno(linebuf, &p->start, &p->end);
-            if (p->start == 0 && p->end == 0) { free(p); continue; } /* 'd' */
-
-            if (*top == NULL) {
-                *top = p;
-                p_prev = p;
-            } else {
-                p_prev->next = p;
-                p_prev = p;
-            }
-        }
-        if (is_end_diff_section(readbuf, fmt)) return;
-    }
+    const char *msg =
+        "Usage: %s [-c0 | -c1 | -a] [-j jobs] [-p] [--stream] [--stamp] [-r remap_diff] [--impact index] [--hot [top]] [--rollup [depth]] [--instances] [--partial out] [-c cvs_diff | -d diffall | -s svn_diff | -g git_diff] (default diff filename -> %s\n"
+        "       %s --index-add index test_name (adds the .gcov files under . as test_name)\n"
+        "       %s [-c0 | -c1 | -a] [--hot [top]] [--rollup [depth]] --merge partial...\n"
+        "       %s [-j jobs] --server socket (answers diffs with ./*.gcov, SIGHUP reloads)\n"
+        "       (-j also bounds the .gcov files read ahead: --stream holds at most 2 x jobs (max 64) x the largest .gcov)\n";
+    printf(msg, cmd_name, DEFAULT_DIFF_FILENAME, cmd_name, cmd_name, cmd_name);
 }
 
 /**
- * parse diff line
- * ex1. 30a31,32 -> start = 31, end = 32
- * ex2. 22,30d22 -> start = 22, end = 22
+ * run diffgcov with option, and print report to stdout
+ * (split from main 20261018, libdiffgcov does no prompt and no print)
+ * 0: ok
+ * -1: err
+ * DGC_ERR_FORMAT: unknown diff format
  */
-void parse_diff_lineno(char *line, int *start, int *end)
+int run_report(OPTION *opt)
 {
-    int i;
-    char *start_p, *end_p;
-
-    for (i = 0; i < strlen(line); i++) {
-        if (line[i] == 'a' || line[i] == 'c') {
-            start_p = line+i+1;
-            end_p = strchr(start_p, ',');
-            if (end_p != NULL) {
-                end_p++;
-            } else {
-                end_p =start_p;
-            }
-            *start = atoi(start_p);
-	        *end   = atoi(end_p);
-            break;
+    DIFF_DATA *diff;
+    GCOV_DATA *gcov;
+    GCOV_STREAM stream, *streamp;
+    REPORT report;
+    TEST_INDEX idx;
+    HOT_RANK hot;
+    MERGE_FILE *merge;
+    FILE *partial;
+    GCOV_DATA *p;
+    ROLLUP rollup;
+    int i, ret, cancel;
+
+    memset(&rollup, 0, sizeof(rollup));
+    strcpy(rollup.name, "./"); /* root (20261018) */
+
+    if (opt->index && opt->index_test) { /* --index-add 20261018 */
+        memset(&idx, 0, sizeof(idx));
+        if (dgc_load_test_index(opt->index, &idx) != 0) return -1;
+        if (dgc_add_test_index(&idx, opt->index_test, (char *)".") != 0 || dgc_save_test_index(opt->index, &idx) != 0) {
+            dgc_free_test_index(&idx);
+            return -1;
         }
+        dgc_free_test_index(&idx);
+        return 0;
     }
-    return;
-}
 
-/**
- * diff data memory free
- */
-void free_diff_data(DIFF_DATA *p)
-{
-    DIFF_DATA *p_next;
-
-    for (; p; p = p_next) {
-        free_line_data(p->line);
-        p_next = p->next;
-        free(p);
+    if (opt->merge) { /* --merge 20261018 */
+        merge = NULL;
+        for (i = 0; i < opt->nmerge; i++) {
+            if (dgc_load_partial(opt->merge[i], &merge) != 0) { dgc_free_merge_data(merge); return -1; }
+        }
+        gcov = dgc_create_gcov_data_merge(merge);
+        if (gcov == NULL) { dgc_free_merge_data(merge); return -1; }
+        calc_gcov(gcov, opt->rollup ? &rollup : NULL);
+        print_gcov(gcov, opt->level);
+        ret = 0;
+        if (opt->hot && print_hot(gcov, opt->hot) != 0) ret = -1; /* 20261018 */
+        if (opt->rollup) {
+            print_rollup(&rollup, opt->level, opt->rollup_depth);
+            free_rollup(rollup.child);
+        }
+        dgc_free_gcov_data(gcov);
+        dgc_free_merge_data(merge);
+        return ret;
     }
-}
 
-/**
- * line data memory free
- */
-void free_line_data(LINE_DATA *p)
-{
-    LINE_DATA *p_next;
+    if (opt->server) { /* --server 20261018 */
+        return dgc_server(opt->server, ".", opt->jobs);
+    }
 
-    for (; p; p = p_next) {
-        p_next = p->next;
-        free(p);
+    if (opt->diff_fmt == DGC_UNKNOWN_FMT) {
+        if ((opt->diff_fmt = dgc_get_diff_format(opt->file)) == DGC_UNKNOWN_FMT) { /* 20100531 */
+            return DGC_ERR_FORMAT;
+        }
     }
-}
 
-/**
- * debug print diff data (unused)
- */
-void debug_print_diff_data(DIFF_DATA *diff)
-{
-    LINE_DATA *line;
+    diff = NULL;
+    dgc_create_diff_data(opt->file, opt->diff_fmt, opt->jobs, &diff);
+    if (diff == NULL) return -1;
 
-    for (; diff; diff = diff->next) {
-        printf("src[%s]\n", diff->src);
-        line = diff->line;
-        for (; line; line = line->next)
-            printf("start[%d] end[%d]\n", line->start, line->end);
+    if (opt->remap) { /* 20261018 */
+        if ((ret = dgc_remap_diff_data(diff, opt->remap)) != 0) {
+            dgc_free_diff_data(diff);
+            return ret;
+        }
     }
-}
 
-/**
- * file read line , next line
- * 0: ok, -1: eof
- */
-int readline(char *buf, READ_BUF *p, FILE *fp)
-{
-    /* crnt -> prev copy */
-    memcpy(p->prev, p->crnt, sizeof(p->crnt));
-    memset(p->crnt, 0, sizeof(p->crnt));
-
-    /* next -> crnt copy */
-    memcpy(p->crnt, p->next, sizeof(p->next));
-    memset(p->next, 0, sizeof(p->next));
+    if (opt->index) { /* --impact 20261018 */
+        memset(&idx, 0, sizeof(idx));
+        if (dgc_load_test_index(opt->index, &idx) != 0) { dgc_free_diff_data(diff); return -1; }
+        print_impact_test(&idx, diff);
+        dgc_free_test_index(&idx);
+        dgc_free_diff_data(diff);
+        return 0;
+    }
 
-    if (p->crnt[0] == '\0') {
-        if (fgets(p->crnt, sizeof(p->crnt)-1, fp) == NULL) {
-            return -1; /* eof */
+    gcov = NULL;
+    memset(&stream, 0, sizeof(stream));
+    memset(&report, 0, sizeof(report));
+    stream.report = report_gcov;
+    stream.arg = &report;
+    report.level = opt->level;
+    if (opt->stream && opt->hot) { /* 20261018 */
+        if (hot_rank_init(&hot, opt->hot) != 0) {
+            dgc_free_diff_data(diff);
+            return -1;
         }
-        cut_LF(p->crnt);
-    }
-    if (p->next[0] == '\0') {
-        if (fgets(p->next, sizeof(p->next)-1, fp) == NULL) {
-            /* next readline is eof */
+        report.hot = &hot;
+    }
+    if (opt->stream && opt->rollup) report.rollup = &rollup; /* 20261018 */
+    report.inst = opt->inst; /* 20261018 */
+    partial = NULL;
+    if (opt->partial) { /* 20261018 */
+        if ((partial = fopen(opt->partial, "w")) == NULL) {
+            printf("!!! %s can not open !!!\n", opt->partial);
+            if (report.hot) hot_rank_free(report.hot);
+            dgc_free_diff_data(diff);
+            return -1;
+        }
+        fprintf(partial, "%s\n", PARTIAL_MAGIC);
+        report.partial = partial;
+    }
+    streamp = opt->stream ? &stream : NULL; /* 20261018 */
+    ret = cancel = 0;
+    if (opt->pipe) { /* 20261018 */
+        if (dgc_create_gcov_data_pipe(diff, &gcov, opt->level, opt->jobs, streamp) != 0) {
+            ret = -1;
+            cancel = 1; /* no report */
         }
-        cut_LF(p->next);
+    } else if (dgc_need_gcov_update(diff, opt->jobs, opt->stamp) && gcov_update(opt->level, opt->jobs, opt->stamp) == 0) {
+        cancel = 1; /* proc cancel */
+    } else {
+        dgc_create_gcov_data(diff, &gcov, opt->jobs, streamp);
+    }
+    if (streamp) gcov = stream.top; /* printed data, freed below (20261018) */
+    if (cancel) {
+        ; /* no report */
+    } else if (streamp) { /* 20261018 */
+        if (gcov == NULL) {
+            ret = -1;
+        } else {
+            report_gcov_finish(&report, gcov);
+            if (report.rollup) print_rollup(report.rollup, opt->level, opt->rollup_depth);
+        }
+    } else if (gcov == NULL) {
+        ret = -1;
+    } else {
+        for (p = gcov; partial && p; p = p->next) dgc_write_partial(partial, p); /* 20261018 */
+        calc_gcov(gcov, opt->rollup ? &rollup : NULL); /* 20261018 */
+        print_gcov(gcov, opt->level);
+        if (opt->hot && print_hot(gcov, opt->hot) != 0) ret = -1; /* 20261018 */
+        if (opt->inst) print_inst(gcov); /* 20261018 */
+        if (opt->rollup) print_rollup(&rollup, opt->level, opt->rollup_depth); /* 20261018 */
     }
-    memcpy(buf, p->crnt, strlen(p->crnt));
-    return 0;
-}
 
-/**
- * cut LF
- */
-void cut_LF(char *p)
-{
-    if (p[strlen(p)-1] == '\n') {
-        p[strlen(p)-1] = '\0';
-    }
-}
-/**
- * check diff start section
- * 1: start
- * 0: not start
- */
-int is_start_diff_section(READ_BUF *p, int fmt)
-{
-   if (fmt == CVS_FMT || fmt == SVN_FMT) {
-       if (p->crnt[0] == 'I')
-           if (strstr(p->crnt, "Index:") != NULL) return 1;
-   } else {
-       if (isalpha(p->crnt[0]) && isdigit(p->next[0])) return 1;
-   }
-   return 0;
-}
+    /* common cleanup (20261018) */
+    if (partial) fclose(partial);
+    if (report.hot) hot_rank_free(report.hot);
+    free_rollup(rollup.child);
+    dgc_free_gcov_data(gcov);
+    dgc_free_diff_data(diff);
 
-/**
- * check diff end section
- * 1: end
- * 0: not end
- */
-int is_end_diff_section(READ_BUF *p, int fmt)
-{
-   if (fmt == CVS_FMT || fmt == SVN_FMT) {
-       if (p->next[0] == 'I')
-           if (strstr(p->next, "Index:") != NULL) return 1;
-   } else {
-       if (isalpha(p->next[0])) return 1;
-   }
-   return 0;
+    return ret;
 }
 
-/*************** diff list -> gcov list **************/
 
 /**
- * create gcov file with diff merge, and create gcov data list
+ * gcov update
+ * 0: proc cancel
+ * 1: proc continue
+ * stamp: contents of .gcda files are saved to STAMP_FILENAME after
+ * gcov is run (20261018)
  */
-void create_gcov_data(DIFF_DATA *diff, GCOV_DATA **top)
+int gcov_update(int level, int jobs, int stamp)
 {
-    FILE *fp;
-    char linebuf[LINEBUFSZ];
-    READ_BUF readbuf; /* 20110210 */
-    char *c1, *c2;
-    char linestr[32];
-    int lineno;
-    LINE_DATA *line;
-    GCOV_DATA *p, *p_prev;
-    GCOV_LINE_DATA *pl, *pl_prev;
-    GCOV_BRANCH_DATA *pb, *pb_prev;
-    unsigned long s_pos, e_pos;
-
-    for (; diff; diff = diff->next) {
-
-        if ((p = (GCOV_DATA *)malloc(sizeof(GCOV_DATA))) == NULL) break;
-        memset(p, 0, sizeof(GCOV_DATA));
-
-        strcat(p->gcov, diff->src);
-        strcat(p->gcov, ".gcov");
-
-        if ((fp = fopen(p->gcov, "r")) == NULL) { free(p); continue; }
-        memset(&readbuf, 0, sizeof(readbuf)); /* 20110210 */
-
-        line = diff->line;
-        for (; line; line = line->next) {
-            while(1) {
-                memset(linebuf, 0, sizeof(linebuf));
-                if (readline(linebuf, &readbuf, fp) == -1) break; /* 20110210 */ /* eof */
-
-                c1 = strchr(linebuf, ':');
-                if (c1 == NULL) continue;
-                c1++;
-                c2 = strchr(c1, ':');
-                memset(linestr, 0, sizeof(linestr));
-                memcpy(linestr, c1, c2-c1);
-                lineno = atoi(linestr);
-
-                if (lineno < line->start) continue;
-
-                if (gcov_line_data_copy(&p->linebuf, linebuf, strlen(linebuf), &s_pos, &e_pos) == 0) break;
-
-                /* -- add 20110210 */
-                if ((pl = (GCOV_LINE_DATA *)malloc(sizeof(GCOV_LINE_DATA))) == NULL) break;
-                memset(pl, 0, sizeof(GCOV_LINE_DATA));
-                pl->s_pos = s_pos;
-                pl->e_pos = e_pos;
-
-                while (readbuf.next[0] != ' ') {
-                    memset(linebuf, 0, sizeof(linebuf));
-                    if (readline(linebuf, &readbuf, fp) == -1) break; /* eof */
-
-                    if (linebuf[0] == 'b' && strstr(linebuf, "branch")) {
-                        if (gcov_line_data_copy(&p->linebuf, linebuf, strlen(linebuf), &s_pos, &e_pos) == 0) break;
-                        if ((pb = (GCOV_BRANCH_DATA *)malloc(sizeof(GCOV_BRANCH_DATA))) == NULL) break;
-                        memset(pb, 0, sizeof(GCOV_BRANCH_DATA));
-                        pb->s_pos = s_pos;
-                        pb->e_pos = e_pos;
-                        if (pl->branch == NULL) {
-                            pl->branch = pb;
-                            pb_prev = pb;
-                        } else {
-                            pb_prev->next = pb;
-                            pb_prev = pb;
-                        }
-                    }
-                }
-                if (p->line == NULL) {
-                    p->line = pl;
-                    pl_prev = pl;
-                } else {
-                    pl_prev->next = pl;
-                    pl_prev = pl;
-                }
-                /* -- add 20110210 */
+    char input[256];
+    char command[256];
+    const char *opt;
 
-                if (lineno+1 > line->end) break;
-            }
-        }
-        fclose(fp);
+    /* -b for all levels, so that one gcov serves line, branch and function (20261018) */
+    opt = dgc_gcov_has_conditions() ? "-b --conditions" : "-b";
+    memset(command, 0, sizeof(command));
+    sprintf(command, "%s %s -f *.gcno", GCOV_COMMAND, opt);
 
-        if (*top == NULL) {
-            *top = p;
-            p_prev = p;
-        } else {
-            p_prev->next = p;
-            p_prev = p;
+    printf("create %s gcov\?[y/n/q]", level == DGC_C0_LINE_LEVEL ? "C0" : level == DGC_C1_BRANCH_LEVEL ? "C1" : "ALL");
+    memset(input, 0, sizeof(input));
+    fgets(input, sizeof(input)-1, stdin);
+    if (input[0] == 'y' || input[0] == 'Y') {
+        printf("create gcov ...\n");
+        system(command);
+        if (stamp && dgc_save_gcda_stamp_dir((char *)STAMP_FILENAME, jobs) != 0) { /* 20261018 */
+            printf("!!! %s can not write !!!\n", STAMP_FILENAME);
         }
+        return 1;
+    } else if (input[0] == 'n' || input[0] == 'N') {
+        return 1;
+    } else {
+        return 0;
     }
 }
 
 /**
- * gcov data memory free
- */
-void free_gcov_data(GCOV_DATA *p)
-{
-    GCOV_DATA *p_next;
-
-    for(; p; p = p_next) {
-        if (p->linebuf.top) free(p->linebuf.top);
-        free_gcov_line_data(p->line); /* 20110210 */
-        p_next = p->next;
-        free(p);
-    }
-}
-
-/**
- * gcov line data memory free
+ * calc gocv data
  */
-void free_gcov_line_data(GCOV_LINE_DATA *p)
+void calc_gcov(GCOV_DATA *p, ROLLUP *rollup)
 {
-    GCOV_LINE_DATA *p_next;
-
-    for(; p; p = p_next) {
-        free_gcov_branch_data(p->branch);
-        p_next = p->next;
-        free(p);
+    for (; p; p = p->next) {
+        dgc_parcent(p);
+        if (rollup) rollup_gcov(rollup, p); /* 20261018 */
     }
 }
 
 /**
- * gcov branch data memory free
+ * print gcov
  */
-void free_gcov_branch_data(GCOV_BRANCH_DATA *p)
+void print_gcov(GCOV_DATA *p, int level)
 {
-    GCOV_BRANCH_DATA *p_next;
+    GCOV_DATA *p_bk = p;
 
-    for(; p; p = p_next) {
-        p_next = p->next;
-        free(p);
+    print_gcov_result_head();
+    for(; p; p = p->next) { /* 20100531 */
+        print_gcov_result(p, level);
     }
+    print_gcov_summary(p_bk, level);
 }
 
-/*************** calc and print (with diff merge gcov file) **************/
 /**
- * calc gocv data
+ * print gcov result head
+ * (split from print_gcov 20261018)
  */
-void calc_gcov(GCOV_DATA *p)
+void print_gcov_result_head(void)
 {
-    for (; p; p = p->next) parcent(p);
+    printf("***************************\n");
+    printf("***** coverage result *****\n");
+    printf("***************************\n");
 }
 
 /**
- * get gcov line executed parcent
+ * print gcov result of one file
+ * (split from print_gcov 20261018)
  */
-void parcent(GCOV_DATA *p)
+void print_gcov_result(GCOV_DATA *p, int level)
 {
-    char linebuf[LINEBUFSZ];
-    char *ptr;
-    GCOV_LINE_DATA *pl;
-    GCOV_BRANCH_DATA *pb;
-
-    for(pl = p->line; pl; pl = pl->next) {
-        memset(linebuf, 0, sizeof(linebuf));
-        if (gcov_line_get_by_pos(&p->linebuf, linebuf, sizeof(linebuf)-1, pl->s_pos, pl->e_pos) == 0) break; /* 20100531 */
-
-        if ((ptr = strchr(linebuf, ':')) == NULL) continue;
-
-        ptr--;
-        if (isdigit(*ptr)) p->line_pass++;
-        else if (*ptr == '#') p->line_notpass++;
-
-        /* -- add 20110210 */
-        for(pb = pl->branch; pb; pb = pb->next) {
-            memset(linebuf, 0, sizeof(linebuf));
-            if (gcov_line_get_by_pos(&p->linebuf, linebuf, sizeof(linebuf)-1, pb->s_pos, pb->e_pos) == 0) break;
-            if (strstr(linebuf, " 0%") || strstr(linebuf, "never")) {
-                pl->branch_notpass++;
-                p->branch_notpass++;
-            } else {
-                pl->branch_pass++;
-                p->branch_pass++;
-            }
-        }
-        /* -- add 20110210 */
-    }
-
-    if ((p->line_pass + p->line_notpass) != 0)
-        p->line_parcent = (double)p->line_pass / (p->line_pass + p->line_notpass) * 100;
-    if ((p->branch_pass + p->branch_notpass) != 0) { /* 20110210 */
-        p->branch_parcent = (double)p->branch_pass / (p->branch_pass + p->branch_notpass) * 100;
-    } else {
-        p->branch_parcent = 100.0;
+    if (p->line_pass == 0 && p->line_notpass == 0 && p->line_unknown == 0) return; /* 解析エラー */
+    printf("%s Lines executed:%02.2f%% (%d/%d)\n", p->gcov, p->line_parcent, p->line_pass, (p->line_pass + p->line_notpass));
+    if (level >= DGC_C1_BRANCH_LEVEL) /* 20110210 */
+        printf("%s Branches executed:%02.2f%% (%d/%d)\n", p->gcov, p->branch_parcent, p->branch_pass, (p->branch_pass + p->branch_notpass));
+    if (level == DGC_ALL_LEVEL) { /* 20261018 */
+        if (p->func_pass + p->func_notpass > 0)
+            printf("%s Functions executed:%02.2f%% (%d/%d)\n", p->gcov, p->func_parcent, p->func_pass, (p->func_pass + p->func_notpass));
+        if (p->cond_pass + p->cond_notpass > 0)
+            printf("%s Conditions covered:%02.2f%% (%d/%d)\n", p->gcov, p->cond_parcent, p->cond_pass, (p->cond_pass + p->cond_notpass));
     }
+    if (p->line_unknown > 0) /* 20261018 */
+        printf("%s Lines unknown:%d (not in coverage baseline)\n", p->gcov, p->line_unknown);
+    print_notpass_line(p, level);
+    print_unknown_line(p);
 }
 
 /**
- * print gcov
+ * print gcov summary (uses counters only)
+ * (split from print_gcov 20261018)
  */
-void print_gcov(GCOV_DATA *p, int level)
+void print_gcov_summary(GCOV_DATA *p, int level)
 {
-    int line_pass, line_notpass, branch_pass, branch_notpass;
-    line_pass = line_notpass = branch_pass = branch_notpass = 0;
-    GCOV_DATA *p_bk = p;
-
-    printf("***************************\n");
-    printf("***** coverage result *****\n");
-    printf("***************************\n");
-    for(; p; p = p->next) { /* 20100531 */
-        if (p->line_pass == 0 && p->line_notpass == 0) continue; /* 解析エラー */
-        printf("%s Lines executed:%02.2f%% (%d/%d)\n", p->gcov, p->line_parcent, p->line_pass, (p->line_pass + p->line_notpass));
-        if (level == C1_BRANCH_LEVEL) /* 20110210 */
-            printf("%s Branches executed:%02.2f%% (%d/%d)\n", p->gcov, p->branch_parcent, p->branch_pass, (p->branch_pass + p->branch_notpass));
-        print_notpass_line(p, level);
-    }
+    int line_pass, line_notpass, branch_pass, branch_notpass, line_unknown;
+    int func_pass, func_notpass, cond_pass, cond_notpass;
+    line_pass = line_notpass = branch_pass = branch_notpass = line_unknown = 0;
+    func_pass = func_notpass = cond_pass = cond_notpass = 0;
 
     printf("*******************\n");
     printf("***** summary *****\n");
     printf("*******************\n");
-    p = p_bk;
     for(; p; p = p->next) {
-        if (p->line_pass == 0 && p->line_notpass == 0) continue; /* 解析エラー */
+        if (p->line_pass == 0 && p->line_notpass == 0 && p->line_unknown == 0) continue; /* 解析エラー */
         line_pass += p->line_pass;
         line_notpass += p->line_notpass;
         branch_pass += p->branch_pass; /* 20110210 */
         branch_notpass += p->branch_notpass;
+        line_unknown += p->line_unknown; /* 20261018 */
+        func_pass += p->func_pass; /* 20261018 */
+        func_notpass += p->func_notpass;
+        cond_pass += p->cond_pass;
+        cond_notpass += p->cond_notpass;
 
         printf("%s Lines executed:%02.2f%% (%d/%d)\n", p->gcov, p->line_parcent, p->line_pass, (p->line_pass + p->line_notpass));
-        if (level == C1_BRANCH_LEVEL) /* 20110210 */
+        if (level >= DGC_C1_BRANCH_LEVEL) /* 20110210 */
             printf("%s Branches executed:%02.2f%% (%d/%d)\n", p->gcov, p->branch_parcent, p->branch_pass, (p->branch_pass + p->branch_notpass));
+        if (level == DGC_ALL_LEVEL) { /* 20261018 */
+            if (p->func_pass + p->func_notpass > 0)
+                printf("%s Functions executed:%02.2f%% (%d/%d)\n", p->gcov, p->func_parcent, p->func_pass, (p->func_pass + p->func_notpass));
+            if (p->cond_pass + p->cond_notpass > 0)
+                printf("%s Conditions covered:%02.2f%% (%d/%d)\n", p->gcov, p->cond_parcent, p->cond_pass, (p->cond_pass + p->cond_notpass));
+        }
+        if (p->line_unknown > 0) /* 20261018 */
+            printf("%s Lines unknown:%d (not in coverage baseline)\n", p->gcov, p->line_unknown);
     }
     if ((line_pass+line_notpass) > 0) {
         printf("Total Lines executed:%02.2f%% (%d/%d)\n", (double)line_pass / (line_pass+line_notpass) * 100, line_pass, (line_pass+line_notpass));
     } else {
         printf("Total Lines executed:100.00%% (%d/%d)\n", line_pass, (line_pass+line_notpass));
     }
-    if (level == C1_BRANCH_LEVEL) { /* 20110210 */
+    if (level >= DGC_C1_BRANCH_LEVEL) { /* 20110210 */
         if ((branch_pass+branch_notpass) > 0) {
             printf("Total Branches executed:%02.2f%% (%d/%d)\n", (double)branch_pass / (branch_pass+branch_notpass) * 100, branch_pass, (branch_pass+branch_notpass));
         } else {
             printf("Total Branches executed:100.00%% (%d/%d)\n", branch_pass, (branch_pass+branch_notpass));
         }
     }
+    if (level == DGC_ALL_LEVEL) { /* 20261018 */
+        if (func_pass + func_notpass > 0) print_metric("Total", "Functions executed", func_pass, func_notpass);
+        if (cond_pass + cond_notpass > 0) print_metric("Total", "Conditions covered", cond_pass, cond_notpass);
+    }
+    if (line_unknown > 0) { /* 20261018 */
+        printf("Total Lines unknown:%d (re-run tests to cover them)\n", line_unknown);
+    }
 }
 
 /**
- * print gcov not pass line
+ * report one gcov data of stream (add 20261018)
+ * called by libdiffgcov with the counters calculated, before the gcov
+ * text and line list are freed.
  */
-void print_notpass_line(GCOV_DATA *p, int level)
+void report_gcov(void *arg, GCOV_DATA *p)
 {
-    char linebuf[LINEBUFSZ];
-    char *ptr;
-    GCOV_LINE_DATA *pl;
-    GCOV_BRANCH_DATA *pb;
-
-    if (p->linebuf.top == NULL) return;
-
-    for(pl = p->line; pl; pl = pl->next) {
-        memset(linebuf, 0, sizeof(linebuf));
-        if (gcov_line_get_by_pos(&p->linebuf, linebuf, sizeof(linebuf)-1, pl->s_pos, pl->e_pos) == 0) break;
-        if (strrchr(linebuf, '\n') != NULL) *strrchr(linebuf, '\n') = 0;
+    REPORT *r = (REPORT *)arg;
 
-        if ((ptr = strchr(linebuf, ':')) == NULL) continue;
-        ptr--;
-        if (level == C0_LINE_LEVEL) {
-            if (*ptr == '#') printf("%s\n", linebuf);
-        } else {
-            if (*ptr == '#' || pl->branch_notpass > 0) printf("%s\n", linebuf);
-            if (pl->branch_notpass > 0) {
-                for (pb = pl->branch; pb; pb = pb->next) {
-                    memset(linebuf, 0, sizeof(linebuf));
-                    if (gcov_line_get_by_pos(&p->linebuf, linebuf, sizeof(linebuf)-1, pb->s_pos, pb->e_pos) == 0) break;
-                    if (strrchr(linebuf, '\n') != NULL) *strrchr(linebuf, '\n') = 0;
-                    printf("%s\n", linebuf);
-                }
-            }
-        }
+    if (!r->started) {
+        print_gcov_result_head();
+        r->started = 1;
     }
+    print_gcov_result(p, r->level);
+    if (r->hot) print_hot_gcov(p, r->hot); /* 20261018 */
+    if (r->inst) print_inst_gcov(p); /* 20261018 */
+    if (r->partial) dgc_write_partial(r->partial, p); /* 20261018 */
+    if (r->rollup) rollup_gcov(r->rollup, p); /* 20261018 */
 }
 
 /**
- * get command line option parameter
- * 0: ok
- * -1: err
+ * print streamed summary (add 20261018)
  */
-int get_option(int argc, char **argv, OPTION *opt)
+void report_gcov_finish(REPORT *r, GCOV_DATA *top)
 {
-    int i;
-
-    opt->diff_fmt = UNKNOWN_FMT;
-    opt->file = (char *)DEFAULT_DIFF_FILENAME; /* 20100531 */
-    opt->level = C0_LINE_LEVEL;
-    if (argc > 1) {
-        for (i = 1; i < argc; i++) {
-            if (!strcmp(argv[i], "-c0") || !strcmp(argv[i], "-C0")) {
-                opt->level = C0_LINE_LEVEL;
-            } else if (!strcmp(argv[i], "-c1") || !strcmp(argv[i], "-C1")) {
-                opt->level = C1_BRANCH_LEVEL;
-            } else if (!strcmp(argv[i], "-c") || !strcmp(argv[i], "--cvsdiff")) {
-                opt->diff_fmt = CVS_FMT;
-            } else if (!strcmp(argv[i], "-d") || !strcmp(argv[i], "--diffall")) {
-                opt->diff_fmt = DIFF_FMT;
-            } else if (!strcmp(argv[i], "-s") || !strcmp(argv[i], "--svndiff")) {
-                opt->diff_fmt = SVN_FMT;
-            } else {
-                opt->file = argv[i];
-            }
-        }
+    if (!r->started) {
+        print_gcov_result_head();
+        r->started = 1;
+    }
+    print_gcov_summary(top, r->level);
+    if (r->hot) { /* 20261018 */
+        print_hot_head();
+        printf("Total Hot lines:\n");
+        print_hot_rank(r->hot, 1);
     }
-    return 0;
 }
 
 /**
- * debug print command line option
+ * print one metric line (add 20261018)
+ * ex) src/ Lines executed:50.00% (2/4)
  */
-void debug_print_option(OPTION *opt)
+void print_metric(const char *name, const char *metric, int pass, int notpass)
 {
-    printf("fmt[%d] file[%s] level[%d]\n", opt->diff_fmt, opt->file, opt->level);
+    int total = pass + notpass;
+
+    printf("%s %s:%02.2f%% (%d/%d)\n", name, metric, total > 0 ? (double)pass / total * 100 : 100.0, pass, total);
 }
 
 /**
- * print out command usage
+ * hot ranking init
+ * 0: ok
+ * -1: error
  */
-void print_usage(char *cmd_name)
+int hot_rank_init(HOT_RANK *rank, int top)
 {
-    const char *msg =
-        "Usage: %s [-c0 | -c1] [-c cvs_diff | -d diffall | -s svn_diff] (default diff filename -> %s\n";
-    printf(msg, cmd_name, DEFAULT_DIFF_FILENAME);
+    memset(rank, 0, sizeof(HOT_RANK));
+    if ((rank->line = (HOT_LINE *)calloc((size_t)top * 2, sizeof(HOT_LINE))) == NULL) { /* 20261018 */
+        printf("!!! hot ranking of %d lines can not allocate !!!\n", top);
+        return -1;
+    }
+    rank->work = rank->line + top; /* 20261018 */
+    rank->top = top;
+    return 0;
 }
 
 /**
- * analyze diff format
- * (add 20100531)
+ * hot ranking memory free
  */
-int get_diff_format(char *filename)
+void hot_rank_free(HOT_RANK *rank)
 {
-    FILE *fp;
-    char linebuf[LINEBUFSZ];
-    READ_BUF readbuf;
-    unsigned long svn, cvs, diffall;
-    int diff_fmt = UNKNOWN_FMT;
+    free(rank->line);
+    memset(rank, 0, sizeof(HOT_RANK));
+}
 
-    svn = cvs = diffall = 0;
+/**
+ * add executed line to ranking (only top lines are kept)
+ */
+void hot_rank_add(HOT_RANK *rank, GCOV_DATA *p, GCOV_LINE_DATA *pl)
+{
+    HOT_LINE hl;
+    GCOV_BRANCH_DATA *pb;
+    char tmp[16];
 
-    if ((fp = fopen(filename, "r")) == NULL) return diff_fmt;
+    if (!pl->exec || pl->count == 0) return;
+    if (rank->n == rank->top && rank->line[rank->n-1].count >= pl->count) return;
 
-    memset(&readbuf, 0, sizeof(readbuf));
+    memset(&hl, 0, sizeof(hl));
+    strcpy(hl.gcov, p->gcov);
+    dgc_gcov_line_get_by_pos(&p->linebuf, hl.text, sizeof(hl.text)-1, pl->s_pos, pl->e_pos);
+    if (strrchr(hl.text, '\n') != NULL) *strrchr(hl.text, '\n') = 0;
+    hl.count = pl->count;
+    for (pb = pl->branch; pb; pb = pb->next) {
+        if (pb->taken < 0) snprintf(tmp, sizeof(tmp), " -");
+        else snprintf(tmp, sizeof(tmp), " %d%%", pb->taken);
+        if (strlen(hl.taken) + strlen(tmp) < sizeof(hl.taken)) strcat(hl.taken, tmp);
+    }
+    hot_rank_copy(rank, &hl);
+}
 
-    while(1) {
-        memset(linebuf, 0, sizeof(linebuf));
-        if (readline(linebuf, &readbuf, fp) == -1) {fclose(fp); break;} /* eof */
+/**
+ * insert hot line to ranking by count
+ */
+void hot_rank_copy(HOT_RANK *rank, HOT_LINE *hl)
+{
+    int i;
 
-        if (linebuf[0] == '@' && linebuf[1] == '@') {
-            svn++;
-        }
-        if (strstr(linebuf, "RCS file")) {
-            cvs++;
-        }
-        if (strstr(linebuf, "Target=")) {
-            diffall++;
-        }
+    if (rank->n == rank->top && rank->line[rank->n-1].count >= hl->count) return;
+    if (rank->n < rank->top) rank->n++;
+    for (i = rank->n - 1; i > 0 && rank->line[i-1].count < hl->count; i--) {
+        rank->line[i] = rank->line[i-1];
     }
-
-    if (diffall > 0)   diff_fmt = DIFF_FMT;
-    if (cvs > diffall) diff_fmt = CVS_FMT;
-    if (svn > cvs)     diff_fmt = SVN_FMT;
-    return diff_fmt;
+    rank->line[i] = *hl;
 }
 
-/****** svn diff format create line data ******/
 /**
- * create line data (for svn diff file)
- * (add 20100531)
+ * print hot changed lines (per file, and total top)
+ * 0: ok
+ * -1: error (20261018)
  */
-void create_line_data_for_svn(FILE *fp, READ_BUF *readbuf, LINE_DATA **top)
+int print_hot(GCOV_DATA *p, int top)
 {
-    char  linebuf[LINEBUFSZ];
-    LINE_DATA *p, *p_prev;
-    int base, crnt, start, end;
+    HOT_RANK total;
 
-    base = crnt = start = end = 0;
-
-    while(1) {
-        if (is_end_diff_section(readbuf, SVN_FMT)) return;
+    if (hot_rank_init(&total, top) != 0) return -1;
+    print_hot_head();
+    for (; p; p = p->next) print_hot_gcov(p, &total);
+    printf("Total Hot lines:\n");
+    print_hot_rank(&total, 1);
+    hot_rank_free(&total);
+    return 0;
+}
 
-        memset(linebuf, 0, sizeof(linebuf));
-        if (readline(linebuf, readbuf, fp) == -1) return; /* eof */
+/**
+ * print hot head
+ */
+void print_hot_head(void)
+{
+    printf("*****************************\n");
+    printf("***** hot changed lines *****\n");
+    printf("*****************************\n");
+}
 
-        if (linebuf[0] == ' ' || linebuf[0] == '+') crnt++;
+/**
+ * print hot changed lines of one file, and add them to total
+ * (the file ranking uses the work lines of total 20261018)
+ */
+void print_hot_gcov(GCOV_DATA *p, HOT_RANK *total)
+{
+    HOT_RANK rank;
+    GCOV_LINE_DATA *pl;
+    int i;
 
-        if (is_svndiff_summary(linebuf)) {
-            crnt = -1;
-            base = get_svndiff_baseline(linebuf);
-        }
+    memset(&rank, 0, sizeof(rank));
+    rank.top = total->top;
+    rank.line = total->work;
+    for (pl = p->line; pl; pl = pl->next) hot_rank_add(&rank, p, pl);
+    if (rank.n > 0) {
+        printf("%s Hot lines:\n", p->gcov);
+        print_hot_rank(&rank, 0);
+    }
+    for (i = 0; i < rank.n; i++) hot_rank_copy(total, &rank.line[i]);
+}
 
-        if (base > 0) {
-            if (is_svndiff_start(readbuf)) {
-                start = base + crnt;
-            }
-            if (is_svndiff_end(readbuf)) {
-                end = base + crnt;
-            }
-        }
+/**
+ * print hot ranking
+ * with_name: 1 print gcov file name
+ */
+void print_hot_rank(HOT_RANK *rank, int with_name)
+{
+    int i;
 
-        if (start > 0 && end > 0) {
-            if ((p = (LINE_DATA *)malloc(sizeof(LINE_DATA))) == NULL) {
-                start = end = 0;
-                continue;
-            }
-            memset(p, 0, sizeof(LINE_DATA));
-            p->start = start;
-            p->end = end;
-            if (*top == NULL) {
-                *top = p;
-                p_prev = p;
-            } else {
-                p_prev->next = p;
-                p_prev = p;
-            }
-            start = end = 0;
-        }
+    for (i = 0; i < rank->n; i++) {
+        if (with_name) printf("%s ", rank->line[i].gcov);
+        printf("%s", rank->line[i].text);
+        if (rank->line[i].taken[0]) printf(" [branch taken%s]", rank->line[i].taken);
+        printf("\n");
     }
 }
 
 /**
- * check svn diff summary line (add 20100531)
- * 1: summary line
- * 0: not summary line
+ * print template instances of changed lines
  */
-int is_svndiff_summary(char *line)
+void print_inst(GCOV_DATA *p)
 {
-    if (line[0] == '@' && line[1] == '@') return 1;
-    return 0;
+    print_inst_head();
+    for (; p; p = p->next) print_inst_gcov(p);
 }
 
 /**
- * check svn diff start section (add 20100531)
- * 1: start
- * 0: not start
- *
- * ex)
- * | aaaaa....
- * |-bbbbb....
- * |+ccccc.... <- start line
- * |+ddddd....
- * | edddd....
+ * print template instances head
  */
-int is_svndiff_start(READ_BUF *p)
+void print_inst_head(void)
 {
-    if (p->prev[0] != '+' && p->crnt[0] == '+') return 1;
-    return 0;
+    printf("******************************\n");
+    printf("***** template instances *****\n");
+    printf("******************************\n");
 }
 
 /**
- * check svn diff end section (add 20100531)
- * 1: end
- * 0: not end
- *
- * ex)
- * | aaaaa....
- * |-bbbbb....
- * |+ccccc....
- * |+ddddd.... <- end line
- * | edddd....
+ * print template instances of one file
+ * ex)        2*:    3:    if (a > b)
+ *       _Z3addIiET_S0_S0_         1:    3:    if (a > b) [branch taken 1/2]
  */
-int is_svndiff_end(READ_BUF *p)
+void print_inst_gcov(GCOV_DATA *p)
 {
-    if (p->crnt[0] == '+' && p->next[0] != '+') return 1;
-    return 0;
+    GCOV_LINE_DATA *pl;
+    GCOV_INST_DATA *pi;
+    int head = 0;
+
+    if (p->linebuf.top == NULL) return;
+    for (pl = p->line; pl; pl = pl->next) {
+        if (pl->inst == NULL) continue;
+        if (!head) printf("%s Instances:\n", p->gcov);
+        head = 1;
+        dgc_gcov_line_print(stdout, &p->linebuf, pl->s_pos, pl->e_pos);
+        for (pi = pl->inst; pi; pi = pi->next) {
+            printf("  %.*s ", (int)(pi->name_e - pi->name_s), p->linebuf.top + pi->name_s);
+            fwrite(p->linebuf.top + pi->s_pos, 1, pi->e_pos - pi->s_pos, stdout);
+            if (pi->branch_pass + pi->branch_notpass > 0)
+                printf(" [branch taken %d/%d]", pi->branch_pass, pi->branch_pass + pi->branch_notpass);
+            printf("\n");
+        }
+    }
 }
 
 /**
- * svn diff summary line analyze (add 20100531)
- * 0: error
- * >0: base line
- *
- * ex)
- * @@ -130,7 +130,7 @@
- *            ^^^
+ * add counters of one gcov data to the path prefix tree
+ * every directory node on the path gets the counters, so the totals of
+ * all levels are made while the files are scored.
+ * ex) "src/lib/foo.c.gcov" -> root, "src/", "src/lib/"
  */
-int get_svndiff_baseline(char *line)
+void rollup_gcov(ROLLUP *root, GCOV_DATA *p)
 {
-    char *p1, *p2;
-    char tmp[16];
+    ROLLUP *node;
+    char *c;
 
-    if ((p1 = strchr(line, '+')) == NULL) return 0;
-    p1++;
-    if ((p2 = strchr(p1, ',')) == NULL) return 0;
+    if (p->line_pass == 0 && p->line_notpass == 0 && p->line_unknown == 0) return; /* 解析エラー */
 
-    memset(tmp, 0, sizeof(tmp));
-    memcpy(tmp, p1, p2-p1);
-    return atoi(tmp);
+    for (node = root, c = p->gcov; node; c++) {
+        node->line_pass += p->line_pass;
+        node->line_notpass += p->line_notpass;
+        node->branch_pass += p->branch_pass;
+        node->branch_notpass += p->branch_notpass;
+        node->func_pass += p->func_pass;
+        node->func_notpass += p->func_notpass;
+        node->cond_pass += p->cond_pass;
+        node->cond_notpass += p->cond_notpass;
+        if ((c = strchr(c, '/')) == NULL) break;
+        node = get_rollup_child(node, p->gcov, c - p->gcov + 1);
+    }
 }
 
-/******* GCOV_LINE_BUF accessor *******/
 /**
- * GCOV_LINE create & data copy (add 20100531)
- * 0: error
- * >0: copied size
- * s_pos : copy start buffer position (output param)
- * e_pos : copy end buffer position (output param)
+ * get child node of path prefix (created if not found)
+ * NULL: error
  */
-unsigned long gcov_line_data_copy(GCOV_LINE_BUF *p, char *data, unsigned long sz, unsigned long *s_pos, unsigned long *e_pos)
+ROLLUP *get_rollup_child(ROLLUP *parent, char *name, unsigned long len)
 {
-    if (p->top == NULL) {
-        if ((p->top = (char *)malloc(LINEBUFSZ * 10)) == NULL) return 0;
-        p->max = LINEBUFSZ * 10;
-        p->pos = 0;
-    }
+    ROLLUP *r, *r_prev = NULL, *nr;
+    int cmp = 1;
 
-    if ( (p->pos + sz) > (p->max - 1) ) {
-        if ((p->top = (char *)realloc(p->top, p->max + (LINEBUFSZ * 10))) == NULL) return 0;
-        p->max = p->max + (LINEBUFSZ * 10);
+    if (len >= FILENAMESZ) return NULL;
+    for (r = parent->child; r; r = r->next) {
+        if ((cmp = strncmp(r->name, name, len)) == 0 && r->name[len] != '\0') cmp = 1;
+        if (cmp >= 0) break;
+        r_prev = r;
     }
-    *s_pos = p->pos;      /* 20110210 */
-    *e_pos = p->pos + sz; /* 20110210 */
-    memcpy(p->top + p->pos, data, sz);
-    p->pos += sz;
-    p->top[p->pos] = 0; /* null terminate */
+    if (r && cmp == 0) return r;
 
-    return sz;
+    if ((nr = (ROLLUP *)malloc(sizeof(ROLLUP))) == NULL) return NULL;
+    memset(nr, 0, sizeof(ROLLUP));
+    memcpy(nr->name, name, len);
+    nr->depth = parent->depth + 1;
+    nr->next = r;
+    if (r_prev == NULL) parent->child = nr;
+    else r_prev->next = nr;
+    return nr;
 }
 
 /**
- * GCOV_LINE gets (add 20100531)
- * 0: error
- * >0: read size
- * attention: \n is not read
+ * print rollup of directories
+ * the root ("./") is printed first, so a flat tree has its totals too.
+ * depth 0: all levels
  */
-int gcov_line_gets(GCOV_LINE_BUF *p, char *out, unsigned long outsz)
+void print_rollup(ROLLUP *root, int level, int depth)
 {
-    int pos = 0;
-
-    if (p->top == NULL) return 0;
-
-    for (pos = 0; pos < outsz; ) {
-        if (p->refpos >= p->pos) break;
-        if (p->top[p->refpos] == '\n') {
-            p->refpos++;
-            break;
-        }
+    printf("******************\n");
+    printf("***** rollup *****\n");
+    printf("******************\n");
+    print_rollup_node(root, level, depth);
+}
 
-        out[pos] = p->top[p->refpos];
-        pos++;
-        p->refpos++;
+/**
+ * print rollup nodes and their children (depth first, in name order)
+ */
+void print_rollup_node(ROLLUP *p, int level, int depth)
+{
+    for (; p; p = p->next) {
+        if (depth > 0 && p->depth > depth) return;
+        print_metric(p->name, "Lines executed", p->line_pass, p->line_notpass);
+        if (level >= DGC_C1_BRANCH_LEVEL)
+            print_metric(p->name, "Branches executed", p->branch_pass, p->branch_notpass);
+        if (level == DGC_ALL_LEVEL && p->func_pass + p->func_notpass > 0)
+            print_metric(p->name, "Functions executed", p->func_pass, p->func_notpass);
+        if (level == DGC_ALL_LEVEL && p->cond_pass + p->cond_notpass > 0)
+            print_metric(p->name, "Conditions covered", p->cond_pass, p->cond_notpass);
+        print_rollup_node(p->child, level, depth);
     }
-    return pos;
 }
 
 /**
- * GCOV_LINE get by position (add 20110210)
- * 0: error
- * >0: read size
- * attention: \n is read
+ * rollup memory free (p: first child)
  */
-int gcov_line_get_by_pos(GCOV_LINE_BUF *p, char *out, unsigned long outsz, unsigned long s_pos, unsigned long e_pos)
+void free_rollup(ROLLUP *p)
 {
-    int pos = 0;
-    int refpos = s_pos;
+    ROLLUP *p_next;
 
-    if (p->top == NULL) return 0;
-
-    for (pos = 0; pos < outsz; ) {
-        if (refpos >= p->pos) break;
-        if (refpos == e_pos) break;
-
-        out[pos] = p->top[refpos];
-        pos++;
-        refpos++;
+    for (; p; p = p_next) {
+        free_rollup(p->child);
+        p_next = p->next;
+        free(p);
     }
-    return pos;
 }
 
 /**
- * GCOV_LINE_BUF refpos reset (add 20100531)
+ * print lines not in coverage baseline (add 20261018)
  */
-void gcov_line_refreset(GCOV_LINE_BUF *p)
+void print_unknown_line(GCOV_DATA *p)
 {
-    p->refpos = 0;
+    LINE_DATA *pl;
+
+    for (pl = p->unknown; pl; pl = pl->next) {
+        if (pl->start == pl->end) printf("    ?????:%5d:(not in coverage baseline)\n", pl->start);
+        else printf("    ?????:%5d-%d:(not in coverage baseline)\n", pl->start, pl->end);
+    }
 }
 
-/***** check gcov file timestamp *****/
 /**
- * check gcov timestamp
- * 0: no need
- * 1: need update gcov file
+ * print gcov not pass line
  */
-int need_gcov_update(DIFF_DATA *diff)
+void print_notpass_line(GCOV_DATA *p, int level)
 {
-    char base[FILENAMESZ];
-    char gcov[FILENAMESZ];
-    char gcda[FILENAMESZ];
-    struct stat gcov_stat;
-    struct stat gcda_stat;
-    int need_update = 0;
-
-    for (; diff; diff = diff->next) {
-        if (strlen(diff->src) == 0) continue;
-        if (strrchr(diff->src, '.'))
-            if (*(strrchr(diff->src, '.') + 1) == 'h') continue; /* header file */
-
-        memset(base, 0, sizeof(base));
-        memset(gcov, 0, sizeof(gcov));
-        memset(gcda, 0, sizeof(gcda));
-        strncpy(base, diff->src, sizeof(base)-1);
-        if (strrchr(base, '.')) *strrchr(base, '.') = 0;
-        sprintf(gcov, "./%s.gcov", diff->src);
-        sprintf(gcda, "./%s.gcda", base);
-
-        memset(&gcda_stat, 0, sizeof(gcda_stat));
-        memset(&gcov_stat, 0, sizeof(gcov_stat));
-        if (stat(gcda, &gcda_stat) < 0) continue;
-        if (stat(gcov, &gcov_stat) < 0) {
-            printf("!!! %s is none !!!\n",gcov);
-            need_update = 1;
-            continue;
-        }
+    char linebuf[LINEBUFSZ];
+    char *ptr;
+    GCOV_LINE_DATA *pl;
+    GCOV_BRANCH_DATA *pb;
+    GCOV_FUNC_DATA *pf;
+    int cond;
+
+    if (p->linebuf.top == NULL) return;
 
-        if (gcov_stat.st_mtime < gcda_stat.st_mtime) {
-            printf("!!! %s needs update !!!\n", gcov);
-            need_update = 1;
+    if (level == DGC_ALL_LEVEL) { /* not called functions (20261018) */
+        for (pf = p->func; pf; pf = pf->next) {
+            if (dgc_gcov_func_called(&p->linebuf, pf) == 0) dgc_gcov_line_print(stdout, &p->linebuf, pf->s_pos, pf->e_pos);
         }
     }
 
-    return need_update;
+    for(pl = p->line; pl; pl = pl->next) {
+        memset(linebuf, 0, sizeof(linebuf));
+        if (dgc_gcov_line_get_by_pos(&p->linebuf, linebuf, sizeof(linebuf)-1, pl->s_pos, pl->e_pos) == 0) break;
+
+        if ((ptr = strchr(linebuf, ':')) == NULL) continue;
+        ptr--;
+        if (level == DGC_C0_LINE_LEVEL) {
+            if (*ptr == '#') dgc_gcov_line_print(stdout, &p->linebuf, pl->s_pos, pl->e_pos); /* 20261018 */
+        } else {
+            cond = level == DGC_ALL_LEVEL && pl->cond_pass < pl->cond_total; /* 20261018 */
+            if (*ptr == '#' || pl->branch_notpass > 0 || cond) dgc_gcov_line_print(stdout, &p->linebuf, pl->s_pos, pl->e_pos);
+            if (pl->branch_notpass > 0) {
+                for (pb = pl->branch; pb; pb = pb->next) dgc_gcov_line_print(stdout, dgc_gcov_branch_buf(p, pb), pb->s_pos, pb->e_pos);
+            }
+            for (pb = pl->cond; cond && pb; pb = pb->next) { /* 20261018 */
+                dgc_gcov_line_print(stdout, dgc_gcov_branch_buf(p, pb), pb->s_pos, pb->e_pos);
+            }
+        }
+    }
 }
 
 /**
- * gcov update
- * 0: proc cancel
- * 1: proc continue
+ * print minimal tests covering the changed lines
+ * (greedy set cover: the test covering most uncovered changed lines
+ *  is taken first)
+ * only the executable changed lines are counted.
  */
-int gcov_update(int level)
+void print_impact_test(TEST_INDEX *idx, DIFF_DATA *diff)
 {
-    char input[256];
-    char command[256];
-    char *opt = (char *)"";
+    INDEX_SRC *s;
+    INDEX_RANGE *r, **item, **tmp_item;
+    LINE_DATA *line;
+    DIFF_DATA *d;
+    int *weight, *tmp_weight, *covered, *taken;
+    int nitem, max, i, t, best, best_weight, w, lineno, nline, nexec, nmiss;
+
+    printf("**************************\n");
+    printf("***** impacted tests *****\n");
+    printf("**************************\n");
+
+    /* changed lines -> index ranges (weight: changed lines in range) */
+    nitem = nline = nexec = 0;
+    max = 64;
+    item = (INDEX_RANGE **)malloc(max * sizeof(INDEX_RANGE *));
+    weight = (int *)malloc(max * sizeof(int));
+    if (item == NULL || weight == NULL) { free(item); free(weight); return; }
+    for (d = diff; d; d = d->next) {
+        if ((s = dgc_get_index_src(idx, d->src, 0)) == NULL) continue; /* reported below (20261018) */
+        for (line = d->line; line; line = line->next) {
+            r = s->range;
+            for (lineno = line->start; lineno <= line->end; lineno++) {
+                for (; r && r->end < lineno; r = r->next);
+                if (r == NULL || lineno < r->start) continue; /* not executable */
+                nline++;
+                if (nitem > 0 && item[nitem-1] == r) { weight[nitem-1]++; continue; }
+                if (nitem == max) {
+                    if ((tmp_item = (INDEX_RANGE **)realloc(item, max * 2 * sizeof(INDEX_RANGE *))) == NULL) { free(item); free(weight); return; }
+                    item = tmp_item;
+                    if ((tmp_weight = (int *)realloc(weight, max * 2 * sizeof(int))) == NULL) { free(item); free(weight); return; }
+                    weight = tmp_weight;
+                    max *= 2;
+                }
+                item[nitem] = r;
+                weight[nitem++] = 1;
+            }
+        }
+    }
 
-    if (level == C1_BRANCH_LEVEL) { /* 20110210 */
-        opt = (char *)"-b";
+    covered = (int *)calloc(nitem + 1, sizeof(int));
+    taken = (int *)calloc(idx->ntest + 1, sizeof(int));
+    while (covered && taken) {
+        best = -1;
+        best_weight = 0;
+        for (t = 0; t < idx->ntest; t++) {
+            if (taken[t]) continue;
+            for (w = i = 0; i < nitem; i++) {
+                if (!covered[i] && (item[i]->tests[t / 64] & (1UL << (t % 64)))) w += weight[i];
+            }
+            if (w > best_weight) {
+                best = t;
+                best_weight = w;
+            }
+        }
+        if (best < 0) break;
+
+        taken[best] = 1;
+        for (i = 0; i < nitem; i++) {
+            if (item[i]->tests[best / 64] & (1UL << (best % 64))) covered[i] = 1;
+        }
+        nexec += best_weight;
+        printf("%s (covers %d changed lines)\n", idx->test[best], best_weight);
     }
-    memset(command, 0, sizeof(command));
-    sprintf(command, "%s %s -f *.gcno", GCOV_COMMAND, opt);
+    printf("Changed lines executed by no test: %d/%d\n", nline - nexec, nline);
 
-    printf("create %s gcov\?[y/n/q]", level == C0_LINE_LEVEL ? "C0" : "C1");
-    memset(input, 0, sizeof(input));
-    fgets(input, sizeof(input)-1, stdin);
-    if (input[0] == 'y' || input[0] == 'Y') {
-        printf("create gcov ...\n");
-        system(command);
-        return 1;
-    } else if (input[0] == 'n' || input[0] == 'N') {
-        return 1;
-    } else {
-        return 0;
+    /* sources with no .gcov in any test are not counted as not executable (20261018) */
+    for (nmiss = 0, d = diff; d; d = d->next) {
+        if (dgc_get_index_src(idx, d->src, 0) != NULL) continue;
+        if (nmiss++ == 0) printf("Changed sources not in test index:\n");
+        printf("%s (%d changed lines)\n", d->src, dgc_count_line_data(d->line));
     }
+
+    free(covered);
+    free(taken);
+    free(item);
+    free(weight);
 }
@@ -0,0 +1,5031 @@
+/**
+ * gcov lines checker (libdiffgcov)
+ * (author murata.muu@gmail.com)
+ * 2009.12.22 new
+ * 2010.01.28 deleteのみの差分ソースは無視
+ * 2010.01.29 diffall fmt
+ * 2010.04.05 ファイル名Index:のみでdiffの実体がない場合は対象外
+ * 2010.05.31 .gcov.diff を作成しない
+ *            svn diff フォーマットに対応
+ *            diffファイルフォーマット自動選択
+ *            default diffファイル名を追加
+ *            gcov timestamp チェック
+ * 2011.02.10 c1 branch coverageに対応
+ * 2026.10.18 diffファイルをセクション単位で並列解析 (-j)
+ *            .gcov/.gcda の open/stat/read を一括非同期化 (io_uring, thread pool)
+ *            gcov --stdout を直接解析する pipe モード (-p, shell を介さず起動, header は object 間で合算)
+ *            1ファイルずつ出力して解放する stream モード (--stream)
+ *            diff解析をフォーマット別 template に分離, git diff フォーマットに対応
+ *            旧リビジョンの gcov を diff の行対応で新リビジョンに写像 (-r)
+ *            (source, line) -> test の転置インデックスで影響テストを選択 (--index-add, --impact)
+ *            実行回数順の hot path レポート (--hot)
+ *            shard ごとの部分結果ファイル出力と結合 (--partial, --merge)
+ *            libdiffgcov に分離 (coverage set の常駐, diff バッファの問い合わせ,
+ *            公開は dgc_* のみ, enum は DGC_ 接頭辞)
+ *            ディレクトリ単位の集計を path prefix tree で一度に計算 (--rollup)
+ *            line, branch, function, condition coverage を一度の走査で集計 (-a)
+ *            .gcov を mmap して行を直接参照 (64bit offset, 行長の制限なし)
+ *            gcov 更新判定を ns 精度の mtime と .gcda の内容 stamp で行う (--stamp)
+ *            template の instance block を行番号 index で集計, instance 別出力 (--instances)
+ *            coverage set を常駐させ Unix domain socket で問い合わせに答える server (--server)
+ *            gcov 更新の確認 (stdin, system) と report 出力は diffgcov に残し, stream は callback で渡す
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <ctype.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <pthread.h>
+#include <errno.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include <dirent.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/signalfd.h>
+#include <sys/wait.h>
+#include "libdiffgcov_int.h" /* 20261018 */
+
+#define PARALLEL_DIFF_MINSZ (1024 * 1024) /* 20261018 */
+#define IO_WINDOW_MAX 64       /* max files in flight or not released (20261018) */
+#define IO_URING_ENTRIES 256
+#define INDEX_MAGIC "DIFFGCOV-INDEX 1"  /* test impact index file (20261018) */
+#define COVERAGE_HASHSZ 1024   /* dgc_coverage gcov file table (20261018) */
+#define FUNC_PENDING_MAX 16    /* function records before one line (20261018) */
+#define STAMP_MAGIC "DIFFGCOV-STAMP 1" /* --stamp gcda content stamps (20261018) */
+#define RESULT_MAGIC "DIFFGCOV-RESULT 1" /* --server response (20261018) */
+#define SERVER_BACKLOG 64
+#define SERVER_QUEUESZ 256     /* accepted connections not answered */
+#define SERVER_TIMEOUT 30      /* sec, request read */
+#define SERVER_REQUEST_MAX (256UL * 1024 * 1024)
+
+enum _io_flag { /* 20261018 */
+    IO_STAT = 1,
+    IO_MAP = 2,               /* open and mmap */
+};
+
+enum _io_backend { /* 20261018 */
+    IO_NONE,
+    IO_URING,
+    IO_THREAD,
+};
+
+enum _io_op { /* 20261018 */
+    IO_OP_OPEN,
+    IO_OP_STATX,
+};
+
+/**
+ * structure define
+ */
+
+struct _block_data {
+    int old_start;
+    int old_count;
+    int new_start;
+    int new_count;
+    struct _block_data *next;
+};
+typedef struct _block_data BLOCK_DATA; /* 20261018 */
+
+struct _map_data {
+    char src[FILENAMESZ];
+    BLOCK_DATA *block;
+    struct _map_data *next;
+};
+typedef struct _map_data MAP_DATA; /* 20261018 */
+
+struct _read_buf {
+    char prev[LINEBUFSZ];
+    char crnt[LINEBUFSZ];
+    char next[LINEBUFSZ];
+};
+typedef struct _read_buf READ_BUF;
+
+struct _gcov_func_scan {
+    int n;                    /* pending function records */
+    int added;                /* records are added to gcov data */
+    int line;                 /* source line is read after the records */
+    int start;                /* lines of the function (first line after the records) */
+    int end;                  /* (last line read before the next records) */
+    unsigned long long s_pos[FUNC_PENDING_MAX]; /* records in gcov data */
+    unsigned long long e_pos[FUNC_PENDING_MAX];
+};
+typedef struct _gcov_func_scan GCOV_FUNC_SCAN; /* 20261018 */
+
+struct _gcov_inst_scan {
+    int sep;                  /* "------------------" is read */
+    int inst;                 /* in instance block */
+    unsigned long long name_s;
+    unsigned long long name_e;
+    int nbranch;              /* branches of current line in the block */
+    unsigned long long count; /* count of current line in the block */
+    GCOV_INST_DATA *pi;       /* current line in the block */
+    GCOV_BRANCH_DATA *cond;   /* conditions of current line in the block */
+};
+typedef struct _gcov_inst_scan GCOV_INST_SCAN; /* 20261018 */
+
+struct _gcov_line_index {
+    int n;
+    int max;
+    GCOV_LINE_DATA **line;    /* sorted by lineno */
+};
+typedef struct _gcov_line_index GCOV_LINE_INDEX; /* 20261018 */
+
+struct _diff_section {
+    char *top;
+    unsigned long sz;
+    int err;
+    DIFF_DATA *diff;
+};
+typedef struct _diff_section DIFF_SECTION; /* 20261018 */
+
+struct _diff_worker {
+    DIFF_SECTION *sect;
+    int nsect;
+    int fmt;
+    int next;
+};
+typedef struct _diff_worker DIFF_WORKER; /* 20261018 */
+
+struct _io_req {
+    char path[FILENAMESZ];
+    int flags;                /* IO_STAT | IO_MAP */
+    int fd;
+    int err;                  /* errno (0: ok) */
+    int pending;              /* io_uring ops in flight */
+    int queued;               /* io_uring ops queued (1 << IO_OP_xxx) (20261018) */
+    int completed;            /* io_uring ops completed (1 << IO_OP_xxx) */
+    unsigned long long size;
+    long long mtime_sec;
+    long mtime_nsec;
+    struct statx stx;         /* io_uring statx buffer */
+    char *buf;                /* IO_MAP: mapped file data (not terminated) */
+    unsigned long long sz;
+    int done;
+    int released;
+};
+typedef struct _io_req IO_REQ; /* 20261018 */
+
+struct _io_uring_ctx {
+    int fd;
+    unsigned entries;
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    void *sq_ptr;
+    void *cq_ptr;
+    size_t sq_sz;
+    size_t cq_sz;
+    unsigned sq_local_tail;
+    unsigned to_submit;
+};
+typedef struct _io_uring_ctx IO_URING_CTX; /* 20261018 */
+
+struct _io_batch {
+    IO_REQ *req;
+    int nreq;
+    int backend;
+    int next;                 /* next request to start */
+    int active;               /* io_uring: requests started, not released */
+    int released;             /* released request count */
+    int window;               /* files in flight or not released (2 x jobs) */
+    IO_URING_CTX ring;
+    pthread_t *th;
+    int nthread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+};
+typedef struct _io_batch IO_BATCH; /* 20261018 */
+
+/**
+ * diff format parser (add 20261018)
+ * one class per format. the parse loops are templates instantiated
+ * per format, so they do not branch on fmt line by line.
+ *  is_start()         : crnt line is section start
+ *  is_end()           : next line is next section start
+ *  is_head()          : mapped line is section start (parallel scan)
+ *  parse_src()        : source name from the start line
+ *  create_line_data() : changed line ranges of one section
+ *  create_block_data(): old -> new change blocks of one section (-r)
+ * (in unnamed namespace, so that the parsers are local to this file)
+ */
+namespace {
+
+struct INDEX_SECTION {  /* "Index: aaa.c" (cvs, svn) */
+    static int is_start(READ_BUF *p);
+    static int is_end(READ_BUF *p);
+    static int is_head(char *top, unsigned long s_pos, unsigned long e_pos, unsigned long sz);
+    static void parse_src(char *p, char *name);
+};
+
+struct CVS_PARSER : INDEX_SECTION {
+    static void create_line_data(FILE *fp, READ_BUF *readbuf, LINE_DATA **top);
+    static void create_block_data(FILE *fp, READ_BUF *readbuf, BLOCK_DATA **top);
+};
+
+struct SVN_PARSER : INDEX_SECTION {
+    static void create_line_data(FILE *fp, READ_BUF *readbuf, LINE_DATA **top);
+    static void create_block_data(FILE *fp, READ_BUF *readbuf, BLOCK_DATA **top);
+};
+
+struct DIFFALL_PARSER { /* "aaa.c" followed by "30a31,32" */
+    static int is_start(READ_BUF *p);
+    static int is_end(READ_BUF *p);
+    static int is_head(char *top, unsigned long s_pos, unsigned long e_pos, unsigned long sz);
+    static void parse_src(char *p, char *name);
+    static void create_line_data(FILE *fp, READ_BUF *readbuf, LINE_DATA **top);
+    static void create_block_data(FILE *fp, READ_BUF *readbuf, BLOCK_DATA **top);
+};
+
+struct GIT_PARSER {     /* "diff --git a/aaa.c b/aaa.c" */
+    static int is_start(READ_BUF *p);
+    static int is_end(READ_BUF *p);
+    static int is_head(char *top, unsigned long s_pos, unsigned long e_pos, unsigned long sz);
+    static void parse_src(char *p, char *name);
+    static void create_line_data(FILE *fp, READ_BUF *readbuf, LINE_DATA **top);
+    static void create_block_data(FILE *fp, READ_BUF *readbuf, BLOCK_DATA **top);
+};
+
+} /* namespace */
+
+struct _merge_branch {
+    int pass;                 /* taken by any shard */
+    char *text;               /* gcov branch line */
+    struct _merge_branch *next;
+};
+typedef struct _merge_branch MERGE_BRANCH; /* 20261018 */
+
+struct _merge_cond {
+    int nterm;
+    unsigned char *mask;      /* not covered outcomes (1: true, 2: false) of all shards */
+    unsigned char *shard;     /* not covered outcomes of current shard */
+    struct _merge_cond *next;
+};
+typedef struct _merge_cond MERGE_COND; /* 20261018 */
+
+struct _merge_func {
+    char name[LINEBUFSZ];
+    unsigned long long called; /* sum of shards */
+    unsigned long long max;    /* called of the shard of rest */
+    char *rest;                /* " returned ..." of the most called shard */
+    struct _merge_func *next;
+};
+typedef struct _merge_func MERGE_FUNC; /* 20261018 */
+
+struct _merge_line {
+    int lineno;
+    int exec;                 /* executable in any shard */
+    unsigned long long count; /* sum of shards */
+    char *src;                /* source text after "count:lineno:" */
+    MERGE_BRANCH *branch;
+    MERGE_COND *cond;         /* condition blocks */
+    int ncond;                /* condition blocks of current shard */
+    struct _merge_line *next;
+};
+typedef struct _merge_line MERGE_LINE; /* 20261018 */
+
+struct _merge_file {
+    char gcov[FILENAMESZ];
+    MERGE_LINE *line;         /* sorted by lineno */
+    MERGE_LINE *cur;          /* last merged line (records are sorted) */
+    MERGE_FUNC *func;
+    LINE_DATA *unknown;
+    struct _merge_file *next;
+}; /* MERGE_FILE (libdiffgcov_int.h) */
+
+struct _gcov_pipe_out {
+    int fd;                   /* read end of gcov stdout (-1: end) */
+    pid_t pid;
+    GCOV_LINE_BUF buf;        /* output not parsed yet */
+    unsigned long long scan;  /* lines before scan are checked */
+    unsigned long long sect;  /* head line of the open section */
+    int open;                 /* a section is open */
+};
+typedef struct _gcov_pipe_out GCOV_PIPE_OUT; /* 20261018 */
+
+struct _gcov_pipe {
+    DIFF_DATA **diffs;
+    GCOV_DATA **gcovs;        /* same index as diffs */
+    MERGE_FILE **merges;      /* headers, summed over the objects */
+    int n;
+    GCOV_STREAM *stream;
+    GCOV_PIPE_OUT *out;       /* one per object */
+    struct pollfd *pfd;       /* one per job */
+};
+typedef struct _gcov_pipe GCOV_PIPE; /* 20261018 */
+
+struct _gcda_stamp {
+    char gcda[FILENAMESZ];
+    unsigned int stamp;       /* gcc checksum stamp of gcda header */
+    unsigned long long size;
+    unsigned long long hash;  /* FNV-1a of whole file */
+};
+typedef struct _gcda_stamp GCDA_STAMP; /* 20261018 */
+
+struct _stamp_table {
+    int n;
+    int max;
+    GCDA_STAMP *stamp;        /* sorted by gcda */
+};
+typedef struct _stamp_table STAMP_TABLE; /* 20261018 */
+
+struct _coverage_file {
+    char gcov[FILENAMESZ];
+    GCOV_LINE_BUF view;       /* .gcov file copied on load */
+    int err;                  /* can not open */
+    struct _coverage_file *next;
+};
+typedef struct _coverage_file COVERAGE_FILE; /* 20261018 */
+
+struct _dgc_coverage {
+    char dir[FILENAMESZ];
+    pthread_mutex_t mutex;    /* for table insert */
+    COVERAGE_FILE *file[COVERAGE_HASHSZ];
+};
+
+struct _server_coverage {
+    DGC_COVERAGE *cov;
+    int ref;                  /* server and queries in flight */
+};
+typedef struct _server_coverage SERVER_COVERAGE; /* 20261018 */
+
+struct _server {
+    char dir[FILENAMESZ];
+    DGC_QUERY_OPTION qopt;    /* diff format detected, jobs loads coverage */
+    int fd;                   /* listen socket */
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    int queue[SERVER_QUEUESZ]; /* accepted connections */
+    int qhead;
+    int nqueue;
+    int stop;
+    SERVER_COVERAGE *cur;     /* swapped by reload */
+    pthread_t *th;
+    int nthread;
+};
+typedef struct _server SERVER; /* 20261018 */
+
+/**
+ * local function
+ */
+static void create_diff_data_fp(FILE *fp, int fmt, DIFF_DATA **top);
+static int create_diff_data_parallel(char *file, int fmt, int jobs, DIFF_DATA **top);
+static int scan_diff_sections(char *top, unsigned long sz, int fmt, unsigned long **offs);
+static void *diff_section_worker(void *arg);
+template <class FMT> static void create_diff_data_t(FILE *fp, DIFF_DATA **top);
+template <class FMT> static void create_line_data_t(FILE *fp, READ_BUF *readbuf, LINE_DATA **top);
+template <class FMT> static void create_hunk_line_data_t(FILE *fp, READ_BUF *readbuf, LINE_DATA **top);
+template <class FMT> static int scan_diff_sections_t(char *top, unsigned long sz, unsigned long **offs);
+static int mem_contains(char *top, unsigned long long s_pos, unsigned long long e_pos, const char *str);
+static int create_map_data(char *file, int fmt, MAP_DATA **top);
+template <class FMT> static void create_map_data_t(FILE *fp, MAP_DATA **top);
+template <class FMT> static void create_block_data_t(FILE *fp, READ_BUF *readbuf, BLOCK_DATA **top);
+template <class FMT> static void create_hunk_block_data_t(FILE *fp, READ_BUF *readbuf, BLOCK_DATA **top);
+static void parse_diff_block(char *line, BLOCK_DATA *p);
+static void free_map_data(MAP_DATA *p);
+static void remap_diff_data(DIFF_DATA *diff, MAP_DATA *map);
+static int remap_lineno(BLOCK_DATA **cur, int *delta, int lineno);
+static void append_line_data(LINE_DATA **top, LINE_DATA **last, int lineno);
+static int get_test_id(TEST_INDEX *idx, char *test);
+static int add_index_lines(TEST_INDEX *idx, INDEX_SRC *s, int *lines, int n, int id);
+static int add_index_range(TEST_INDEX *idx, INDEX_RANGE ***cur, int start, int end, int id);
+static void join_index_range(TEST_INDEX *idx, INDEX_SRC *s);
+static INDEX_RANGE *new_index_range(TEST_INDEX *idx, int start, int end, unsigned long *tests);
+static int read_gcov_executed(char *file, int **lines, int all);
+static int compare_int(const void *a, const void *b);
+static MERGE_FILE *get_merge_file(MERGE_FILE **top, char *gcov);
+static MERGE_LINE *get_merge_line(MERGE_FILE *f, int lineno);
+static int merge_gcov_line(MERGE_FILE *f, char *line, MERGE_LINE **ml);
+static int merge_gcov_branch(MERGE_LINE *ml, int idx, char *line);
+static void merge_unknown_line(MERGE_FILE *f, int start, int end);
+static int merge_gcov_func(MERGE_FILE *f, char *line);
+static int merge_gcov_cond(MERGE_LINE *ml, char *line);
+static void merge_cond_flush(MERGE_LINE *ml);
+static void free_merge_cond(MERGE_COND *p);
+static COVERAGE_FILE *get_coverage_file(DGC_COVERAGE *cov, char *src, int *err);
+static int is_safe_src(char *src);
+static COVERAGE_FILE *insert_coverage_file(DGC_COVERAGE *cov, COVERAGE_FILE *nf);
+static int list_dir_files(char *dir, const char *rel, const char *ext, char ***names, int *n, int *max);
+static void *server_worker(void *arg);
+static void server_request(SERVER *s, int fd);
+static void write_query_result(FILE *fp, DGC_RESULT *result);
+static void write_escaped_name(FILE *fp, char *name);
+static int server_reload(SERVER *s);
+static SERVER_COVERAGE *server_coverage_open(char *dir, const DGC_QUERY_OPTION *opt);
+static SERVER_COVERAGE *server_coverage_get(SERVER *s);
+static void server_coverage_put(SERVER *s, SERVER_COVERAGE *sc);
+static unsigned int hash_name(char *name);
+static int create_query_result(GCOV_DATA *gcov, DGC_FILE_RESULT *r, DGC_RESULT *result);
+static void parse_diff_lineno(char *line, int *start, int *end);
+static void free_line_data(LINE_DATA *p);
+static int readline(char *buf, READ_BUF *p, FILE *fp);
+static void cut_LF(char *p);
+static void create_gcov_line_data(GCOV_DATA *p, LINE_DATA *line);
+static void scan_gcov_func(GCOV_FUNC_SCAN *fs, GCOV_LINE_BUF *buf, unsigned long long s_pos, unsigned long long e_pos);
+static void add_gcov_func(GCOV_FUNC_SCAN *fs, GCOV_DATA *p, int lineno, int exec);
+static int is_gcov_line_exec(GCOV_LINE_BUF *buf, unsigned long long s_pos, unsigned long long e_pos);
+static int is_gcov_func_record(GCOV_LINE_BUF *buf, unsigned long long s_pos, unsigned long long e_pos);
+static int is_gcov_cond_record(GCOV_LINE_BUF *buf, unsigned long long s_pos, unsigned long long e_pos);
+static int append_gcov_branch_data(GCOV_LINE_BUF *linebuf, GCOV_BRANCH_DATA **top, char *line);
+static int append_gcov_branch_pos(GCOV_BRANCH_DATA **top, unsigned long long s_pos, unsigned long long e_pos);
+static int is_gcov_inst_separator(GCOV_LINE_BUF *buf, unsigned long long s_pos, unsigned long long e_pos);
+static int is_gcov_branch_pass(GCOV_LINE_BUF *buf, unsigned long long s_pos, unsigned long long e_pos);
+static int merge_gcov_branch_pos(GCOV_LINE_BUF *buf, GCOV_BRANCH_DATA **top, int idx, unsigned long long count, unsigned long long s_pos, unsigned long long e_pos);
+static GCOV_INST_DATA *append_gcov_inst_data(GCOV_LINE_DATA *pl, unsigned long long name_s, unsigned long long name_e, unsigned long long s_pos, unsigned long long e_pos);
+static void flush_gcov_inst_cond(GCOV_LINE_BUF *buf, GCOV_LINE_DATA *pl, GCOV_INST_SCAN *is);
+static void join_gcov_inst_data(GCOV_DATA *p);
+static int append_gcov_joined_branch(GCOV_DATA *p, GCOV_BRANCH_DATA *pb);
+static int append_merge_cond(GCOV_LINE_BUF *buf, GCOV_BRANCH_DATA **top, MERGE_COND *mc);
+static int add_gcov_line_index(GCOV_LINE_INDEX *index, GCOV_LINE_DATA *pl);
+static GCOV_LINE_DATA *find_gcov_line_index(GCOV_LINE_INDEX *index, int lineno);
+static void create_gcov_data_section(GCOV_PIPE *gp, GCOV_LINE_BUF *buf, unsigned long long sect, unsigned long long end);
+static int gcov_spawn(char *src, int branch, int cond, pid_t *pid);
+static int gcov_pipe_read(GCOV_PIPE *gp, int head, int tail);
+static void gcov_pipe_parse(GCOV_PIPE *gp, GCOV_PIPE_OUT *o, int eof);
+static int merge_gcov_data(MERGE_FILE **top, GCOV_DATA *p);
+static char *gcov_line_strdup(GCOV_LINE_BUF *p, unsigned long long s_pos, unsigned long long e_pos);
+static int is_gcov_source_head(GCOV_LINE_BUF *buf, unsigned long long s_pos, unsigned long long e_pos);
+static int is_same_source(char *gcov_src, char *diff_src);
+static int is_header_file(char *src);
+static void free_gcov_line_data(GCOV_LINE_DATA *p);
+static void free_gcov_branch_data(GCOV_BRANCH_DATA *p);
+static void free_gcov_func_data(GCOV_FUNC_DATA *p);
+static void free_gcov_inst_data(GCOV_INST_DATA *p);
+static void stream_gcov(GCOV_STREAM *stream, GCOV_DATA *p);
+static unsigned long long parse_gcov_count(char *line, int *exec);
+static int parse_branch_taken(char *line);
+static unsigned long long parse_func_called(char *line);
+static int get_diff_format_fp(FILE *fp);
+static int is_svndiff_summary(char *line);
+static int is_svndiff_start(READ_BUF *p);
+static int is_svndiff_end(READ_BUF *p);
+static int get_svndiff_baseline(char *line);
+static unsigned long long gcov_line_data_copy(GCOV_LINE_BUF *p, char *data, unsigned long long sz, unsigned long long *s_pos, unsigned long long *e_pos);
+static unsigned long long gcov_line_data_printf(GCOV_LINE_BUF *p, unsigned long long *s_pos, unsigned long long *e_pos, const char *fmt, ...);
+static int gcov_line_map(GCOV_LINE_BUF *p, char *path);
+static int gcov_line_dup(GCOV_LINE_BUF *p, char *data, unsigned long long sz);
+static void gcov_line_free(GCOV_LINE_BUF *p);
+static int gcov_line_next(GCOV_LINE_BUF *p, unsigned long long *s_pos, unsigned long long *e_pos);
+static int gcov_line_lineno(GCOV_LINE_BUF *p, unsigned long long s_pos, unsigned long long e_pos);
+static int load_gcda_stamp(char *file, STAMP_TABLE *t);
+static void set_gcda_stamp(GCDA_STAMP *s, IO_REQ *r);
+static GCDA_STAMP *find_gcda_stamp(STAMP_TABLE *t, char *gcda);
+static int compare_gcda_stamp(const void *a, const void *b);
+static unsigned long long hash_data(char *data, unsigned long long sz);
+static void free_gcda_stamp(STAMP_TABLE *t);
+static int io_batch_submit(IO_BATCH *b, IO_REQ *req, int nreq, int jobs);
+static int io_batch_wait(IO_BATCH *b, int i);
+static void io_batch_release(IO_BATCH *b, int i);
+static void io_batch_finish(IO_BATCH *b);
+static void io_sync_req(IO_REQ *r);
+static void io_map_fd(IO_REQ *r);
+static void *io_thread_worker(void *arg);
+static int io_uring_init(IO_URING_CTX *ctx, unsigned entries);
+static void io_uring_exit(IO_URING_CTX *ctx);
+static struct io_uring_sqe *io_uring_get_sqe(IO_URING_CTX *ctx);
+static int io_uring_submit_wait(IO_URING_CTX *ctx, unsigned wait_nr);
+static int io_uring_start_req(IO_BATCH *b, int i);
+static int io_uring_reap(IO_BATCH *b, int wait);
+static void io_uring_complete(IO_BATCH *b, int i, int op, int res);
+static void io_uring_finish_req(IO_BATCH *b, IO_REQ *r);
+static void io_uring_abort(IO_BATCH *b);
+
+/**
+ * create diff data
+ */
+void dgc_create_diff_data(char *file, int fmt, int jobs, DIFF_DATA **top) /* 20261018 */
+{
+    FILE *fp;
+
+    if (jobs > 1) { /* 20261018 */
+        if (create_diff_data_parallel(file, fmt, jobs, top) == 0) return;
+    }
+
+    if ((fp = fopen(file, "r")) == NULL) return;
+    create_diff_data_fp(fp, fmt, top);
+    fclose(fp);
+}
+
+/**
+ * create diff data from opened stream
+ * (split from create_diff_data 20261018)
+ * fmt is dispatched here once, to the parser of the format.
+ */
+static void create_diff_data_fp(FILE *fp, int fmt, DIFF_DATA **top)
+{
+    switch (fmt) {
+    case DGC_CVS_FMT: create_diff_data_t<CVS_PARSER>(fp, top);     break;
+    case DGC_DIFF_FMT: create_diff_data_t<DIFFALL_PARSER>(fp, top); break;
+    case DGC_SVN_FMT: create_diff_data_t<SVN_PARSER>(fp, top);     break;
+    case DGC_GIT_FMT: create_diff_data_t<GIT_PARSER>(fp, top);     break;
+    }
+}
+
+/**
+ * create diff data (per format)
+ */
+template <class FMT> static void create_diff_data_t(FILE *fp, DIFF_DATA **top)
+{
+    char linebuf[LINEBUFSZ];
+    READ_BUF readbuf;
+    DIFF_DATA *p, *p_prev;
+
+    memset(&readbuf, 0, sizeof(readbuf));
+
+    while(1) {
+        memset(linebuf, 0, sizeof(linebuf));
+        if (readline(linebuf, &readbuf, fp) == -1) return; /* eof */
+
+        if (FMT::is_start(&readbuf)) {
+            if ((p = (DIFF_DATA *)malloc(sizeof(DIFF_DATA))) == NULL) continue;
+
+            memset(p, 0, sizeof(DIFF_DATA));
+            FMT::parse_src(linebuf, p->src);
+            FMT::create_line_data(fp, &readbuf, &p->line);
+            if (p->line == NULL) { free(p); continue; } /* diff is only 'd' */
+
+            if (*top == NULL) {
+                *top = p;
+                p_prev = p;
+            } else {
+                p_prev->next = p;
+                p_prev = p;
+            }
+        }
+    }
+}
+
+/**
+ * create line data (normal diff format "30a31,32", per format)
+ */
+template <class FMT> static void create_line_data_t(FILE *fp, READ_BUF *readbuf, LINE_DATA **top)
+{
+    char linebuf[LINEBUFSZ];
+    LINE_DATA *p, *p_prev;
+
+    while(1) {
+        if (FMT::is_end(readbuf)) return; /* add murata 20100405 */
+
+        memset(linebuf, 0, sizeof(linebuf));
+        if (readline(linebuf, readbuf, fp) == -1) return; /* eof */
+
+        if (isdigit(linebuf[0])) {
+            if ((p = (LINE_DATA *)malloc(sizeof(LINE_DATA))) == NULL) continue;
+
+            memset(p, 0, sizeof(LINE_DATA));
+            parse_diff_lineno(linebuf, &p->start, &p->end);
+            if (p->start == 0 && p->end == 0) { free(p); continue; } /* 'd' */
+
+            if (*top == NULL) {
+                *top = p;
+                p_prev = p;
+            } else {
+                p_prev->next = p;
+                p_prev = p;
+            }
+        }
+        if (FMT::is_end(readbuf)) return;
+    }
+}
+
+/**
+ * create line data (unified diff format "@@ -a,b +c,d @@", per format)
+ * (from create_line_data_for_svn 20100531)
+ */
+template <class FMT> static void create_hunk_line_data_t(FILE *fp, READ_BUF *readbuf, LINE_DATA **top)
+{
+    char  linebuf[LINEBUFSZ];
+    LINE_DATA *p, *p_prev;
+    int base, crnt, start, end;
+
+    base = crnt = start = end = 0;
+
+    while(1) {
+        if (FMT::is_end(readbuf)) return;
+
+        memset(linebuf, 0, sizeof(linebuf));
+        if (readline(linebuf, readbuf, fp) == -1) return; /* eof */
+
+        if (linebuf[0] == ' ' || linebuf[0] == '+') crnt++;
+
+        if (is_svndiff_summary(linebuf)) {
+            crnt = -1;
+            base = get_svndiff_baseline(linebuf);
+        }
+
+        if (base > 0) {
+            if (is_svndiff_start(readbuf)) {
+                start = base + crnt;
+            }
+            if (is_svndiff_end(readbuf)) {
+                end = base + crnt;
+            }
+        }
+
+        if (start > 0 && end > 0) {
+            if ((p = (LINE_DATA *)malloc(sizeof(LINE_DATA))) == NULL) {
+                start = end = 0;
+                continue;
+            }
+            memset(p, 0, sizeof(LINE_DATA));
+            p->start = start;
+            p->end = end;
+            if (*top == NULL) {
+                *top = p;
+                p_prev = p;
+            } else {
+                p_prev->next = p;
+                p_prev = p;
+            }
+            start = end = 0;
+        }
+    }
+}
+
+/****** diff format parsers (add 20261018) ******/
+/**
+ * Index: section start / end
+ * 1: yes
+ * 0: no
+ */
+int INDEX_SECTION::is_start(READ_BUF *p)
+{
+    if (p->crnt[0] == 'I')
+        if (strstr(p->crnt, "Index:") != NULL) return 1;
+    return 0;
+}
+
+int INDEX_SECTION::is_end(READ_BUF *p)
+{
+    if (p->next[0] == 'I')
+        if (strstr(p->next, "Index:") != NULL) return 1;
+    return 0;
+}
+
+int INDEX_SECTION::is_head(char *top, unsigned long s_pos, unsigned long e_pos, unsigned long sz)
+{
+    if (top[s_pos] != 'I') return 0;
+    return mem_contains(top, s_pos, e_pos, "Index:");
+}
+
+/**
+ * parse diff src name
+ * ex Index: aaa.c -> aaa.c
+ */
+void INDEX_SECTION::parse_src(char *p, char *name)
+{
+    if (p = strstr(p, "Index:")) {
+        p = p + strlen("Index:");
+        p++; /* space */
+        strncpy(name, p, FILENAMESZ - 1); /* name[FILENAMESZ] (20261018) */
+        name[FILENAMESZ - 1] = 0;
+    }
+}
+
+void CVS_PARSER::create_line_data(FILE *fp, READ_BUF *readbuf, LINE_DATA **top)
+{
+    create_line_data_t<CVS_PARSER>(fp, readbuf, top);
+}
+
+void CVS_PARSER::create_block_data(FILE *fp, READ_BUF *readbuf, BLOCK_DATA **top)
+{
+    create_block_data_t<CVS_PARSER>(fp, readbuf, top);
+}
+
+void SVN_PARSER::create_line_data(FILE *fp, READ_BUF *readbuf, LINE_DATA **top)
+{
+    create_hunk_line_data_t<SVN_PARSER>(fp, readbuf, top);
+}
+
+void SVN_PARSER::create_block_data(FILE *fp, READ_BUF *readbuf, BLOCK_DATA **top)
+{
+    create_hunk_block_data_t<SVN_PARSER>(fp, readbuf, top);
+}
+
+/**
+ * diffall section start / end
+ * 1: yes
+ * 0: no
+ */
+int DIFFALL_PARSER::is_start(READ_BUF *p)
+{
+    if (isalpha(p->crnt[0]) && isdigit(p->next[0])) return 1;
+    return 0;
+}
+
+int DIFFALL_PARSER::is_end(READ_BUF *p)
+{
+    if (isalpha(p->next[0])) return 1;
+    return 0;
+}
+
+int DIFFALL_PARSER::is_head(char *top, unsigned long s_pos, unsigned long e_pos, unsigned long sz)
+{
+    if (isalpha(top[s_pos]) && e_pos < sz && isdigit(top[e_pos])) return 1;
+    return 0;
+}
+
+/**
+ * parse diff src name (whole line)
+ */
+void DIFFALL_PARSER::parse_src(char *p, char *name)
+{
+    strncpy(name, p, FILENAMESZ - 1); /* name[FILENAMESZ] (20261018) */
+    name[FILENAMESZ - 1] = 0;
+}
+
+void DIFFALL_PARSER::create_line_data(FILE *fp, READ_BUF *readbuf, LINE_DATA **top)
+{
+    create_line_data_t<DIFFALL_PARSER>(fp, readbuf, top);
+}
+
+void DIFFALL_PARSER::create_block_data(FILE *fp, READ_BUF *readbuf, BLOCK_DATA **top)
+{
+    create_block_data_t<DIFFALL_PARSER>(fp, readbuf, top);
+}
+
+/**
+ * git diff section start / end
+ * 1: yes
+ * 0: no
+ */
+int GIT_PARSER::is_start(READ_BUF *p)
+{
+    if (strncmp(p->crnt, "diff --git ", 11) == 0) return 1;
+    return 0;
+}
+
+int GIT_PARSER::is_end(READ_BUF *p)
+{
+    if (strncmp(p->next, "diff --git ", 11) == 0) return 1;
+    return 0;
+}
+
+int GIT_PARSER::is_head(char *top, unsigned long s_pos, unsigned long e_pos, unsigned long sz)
+{
+    if (e_pos - s_pos < 11) return 0;
+    if (memcmp(top + s_pos, "diff --git ", 11) == 0) return 1;
+    return 0;
+}
+
+/**
+ * parse diff src name
+ * ex diff --git a/aaa.c b/aaa.c -> aaa.c
+ */
+void GIT_PARSER::parse_src(char *p, char *name)
+{
+    char *b;
+
+    if ((b = strstr(p, " b/")) == NULL) return;
+    while (strstr(b + 1, " b/")) b = strstr(b + 1, " b/");
+    strncpy(name, b + 3, FILENAMESZ - 1);
+    name[FILENAMESZ - 1] = 0;
+}
+
+void GIT_PARSER::create_line_data(FILE *fp, READ_BUF *readbuf, LINE_DATA **top)
+{
+    create_hunk_line_data_t<GIT_PARSER>(fp, readbuf, top);
+}
+
+void GIT_PARSER::create_block_data(FILE *fp, READ_BUF *readbuf, BLOCK_DATA **top)
+{
+    create_hunk_block_data_t<GIT_PARSER>(fp, readbuf, top);
+}
+
+/****** remap coverage through diff (add 20261018) ******/
+/**
+ * remap diff data onto the revision of .gcov files (-r)
+ * (used by diffgcov -r 20261018)
+ * 0: ok
+ * -1: error (can not open)
+ * DGC_ERR_FORMAT: unknown diff format
+ */
+int dgc_remap_diff_data(DIFF_DATA *diff, char *file)
+{
+    MAP_DATA *map = NULL;
+    int ret;
+
+    if ((ret = create_map_data(file, dgc_get_diff_format(file), &map)) == 0) {
+        remap_diff_data(diff, map);
+    }
+    free_map_data(map);
+    return ret;
+}
+
+/**
+ * create map data (old -> new change blocks) from remap diff file
+ * the remap diff is from the revision of .gcov files to the sources
+ * the review diff is made against.
+ * 0: ok
+ * -1: error (can not open)
+ * DGC_ERR_FORMAT: unknown diff format
+ */
+static int create_map_data(char *file, int fmt, MAP_DATA **top)
+{
+    FILE *fp;
+    int ret = 0;
+
+    if ((fp = fopen(file, "r")) == NULL) {
+        printf("!!! %s can not open !!!\n", file);
+        return -1;
+    }
+    switch (fmt) {
+    case DGC_CVS_FMT: create_map_data_t<CVS_PARSER>(fp, top);     break;
+    case DGC_DIFF_FMT: create_map_data_t<DIFFALL_PARSER>(fp, top); break;
+    case DGC_SVN_FMT: create_map_data_t<SVN_PARSER>(fp, top);     break;
+    case DGC_GIT_FMT: create_map_data_t<GIT_PARSER>(fp, top);     break;
+    default: ret = DGC_ERR_FORMAT;                             break;
+    }
+    fclose(fp);
+    return ret;
+}
+
+/**
+ * create map data (per format)
+ */
+template <class FMT> static void create_map_data_t(FILE *fp, MAP_DATA **top)
+{
+    char linebuf[LINEBUFSZ];
+    READ_BUF readbuf;
+    MAP_DATA *p, *p_prev;
+
+    memset(&readbuf, 0, sizeof(readbuf));
+
+    while(1) {
+        memset(linebuf, 0, sizeof(linebuf));
+        if (readline(linebuf, &readbuf, fp) == -1) return; /* eof */
+
+        if (FMT::is_start(&readbuf)) {
+            if ((p = (MAP_DATA *)malloc(sizeof(MAP_DATA))) == NULL) continue;
+
+            memset(p, 0, sizeof(MAP_DATA));
+            FMT::parse_src(linebuf, p->src);
+            FMT::create_block_data(fp, &readbuf, &p->block);
+
+            if (*top == NULL) {
+                *top = p;
+                p_prev = p;
+            } else {
+                p_prev->next = p;
+                p_prev = p;
+            }
+        }
+    }
+}
+
+/**
+ * create change blocks (normal diff format, per format)
+ */
+template <class FMT> static void create_block_data_t(FILE *fp, READ_BUF *readbuf, BLOCK_DATA **top)
+{
+    char linebuf[LINEBUFSZ];
+    BLOCK_DATA *p, *p_prev;
+
+    while(1) {
+        if (FMT::is_end(readbuf)) return;
+
+        memset(linebuf, 0, sizeof(linebuf));
+        if (readline(linebuf, readbuf, fp) == -1) return; /* eof */
+
+        if (isdigit(linebuf[0])) {
+            if ((p = (BLOCK_DATA *)malloc(sizeof(BLOCK_DATA))) == NULL) continue;
+
+            memset(p, 0, sizeof(BLOCK_DATA));
+            parse_diff_block(linebuf, p);
+
+            if (*top == NULL) {
+                *top = p;
+                p_prev = p;
+            } else {
+                p_prev->next = p;
+                p_prev = p;
+            }
+        }
+        if (FMT::is_end(readbuf)) return;
+    }
+}
+
+/**
+ * create change blocks (unified diff format, per format)
+ * a run of '-' and '+' lines is one block.
+ */
+template <class FMT> static void create_hunk_block_data_t(FILE *fp, READ_BUF *readbuf, BLOCK_DATA **top)
+{
+    char linebuf[LINEBUFSZ];
+    char *p1;
+    BLOCK_DATA *p, *p_prev;
+    int old_lineno, new_lineno;
+
+    p = NULL;
+    old_lineno = new_lineno = 0;
+
+    while(1) {
+        if (FMT::is_end(readbuf)) return;
+
+        memset(linebuf, 0, sizeof(linebuf));
+        if (readline(linebuf, readbuf, fp) == -1) return; /* eof */
+
+        if (is_svndiff_summary(linebuf)) {
+            /* @@ -130,7 +130,8 @@ */
+            p = NULL;
+            old_lineno = new_lineno = 0;
+            if ((p1 = strchr(linebuf, '-')) != NULL) old_lineno = atoi(p1 + 1);
+            new_lineno = get_svndiff_baseline(linebuf);
+            continue;
+        }
+        if (new_lineno == 0 && old_lineno == 0) continue; /* header */
+
+        if (linebuf[0] == '-' || linebuf[0] == '+') {
+            if (p == NULL) {
+                if ((p = (BLOCK_DATA *)malloc(sizeof(BLOCK_DATA))) == NULL) continue;
+                memset(p, 0, sizeof(BLOCK_DATA));
+                p->old_start = old_lineno;
+                p->new_start = new_lineno;
+                if (*top == NULL) {
+                    *top = p;
+                    p_prev = p;
+                } else {
+                    p_prev->next = p;
+                    p_prev = p;
+                }
+            }
+            if (linebuf[0] == '-') {
+                p->old_count++;
+                old_lineno++;
+            } else {
+                p->new_count++;
+                new_lineno++;
+            }
+        } else if (linebuf[0] == ' ') {
+            p = NULL;
+            old_lineno++;
+            new_lineno++;
+        }
+    }
+}
+
+/**
+ * parse normal diff command to change block
+ * ex1. 30a31,32 -> old 31 (0 lines), new 31-32
+ * ex2. 22,30d21 -> old 22-30,        new 22 (0 lines)
+ * ex3. 5,6c5    -> old 5-6,          new 5
+ */
+static void parse_diff_block(char *line, BLOCK_DATA *p)
+{
+    int old_s, old_e, new_s, new_e;
+    char cmd, *c;
+
+    old_s = old_e = atoi(line);
+    for (c = line; isdigit(*c); c++);
+    if (*c == ',') {
+        old_e = atoi(++c);
+        for (; isdigit(*c); c++);
+    }
+    cmd = *c++;
+    new_s = new_e = atoi(c);
+    for (; isdigit(*c); c++);
+    if (*c == ',') new_e = atoi(c + 1);
+
+    if (cmd == 'a') {
+        p->old_start = old_s + 1;
+        p->old_count = 0;
+        p->new_start = new_s;
+        p->new_count = new_e - new_s + 1;
+    } else if (cmd == 'd') {
+        p->old_start = old_s;
+        p->old_count = old_e - old_s + 1;
+        p->new_start = new_s + 1;
+        p->new_count = 0;
+    } else {
+        p->old_start = old_s;
+        p->old_count = old_e - old_s + 1;
+        p->new_start = new_s;
+        p->new_count = new_e - new_s + 1;
+    }
+}
+
+/**
+ * map data memory free
+ */
+static void free_map_data(MAP_DATA *p)
+{
+    MAP_DATA *p_next;
+    BLOCK_DATA *b, *b_next;
+
+    for (; p; p = p_next) {
+        for (b = p->block; b; b = b_next) {
+            b_next = b->next;
+            free(b);
+        }
+        p_next = p->next;
+        free(p);
+    }
+}
+
+/**
+ * project diff line ranges onto coverage baseline
+ * line ranges are rewritten to baseline line numbers, and lines that
+ * have no baseline line (added or changed since) go to diff->unknown.
+ * sources not in map are unchanged since baseline.
+ */
+static void remap_diff_data(DIFF_DATA *diff, MAP_DATA *map)
+{
+    MAP_DATA *m;
+    BLOCK_DATA *cur;
+    LINE_DATA *line, *old_top, *old_last, *unknown_last;
+    int lineno, old_lineno, delta;
+
+    for (; diff; diff = diff->next) {
+        for (m = map; m; m = m->next) {
+            if (strcmp(m->src, diff->src) == 0) break;
+        }
+        if (m == NULL) continue;
+
+        cur = m->block;
+        delta = 0;
+        old_top = old_last = unknown_last = NULL;
+        for (line = diff->line; line; line = line->next) {
+            for (lineno = line->start; lineno <= line->end; lineno++) {
+                if ((old_lineno = remap_lineno(&cur, &delta, lineno)) == 0) {
+                    append_line_data(&diff->unknown, &unknown_last, lineno);
+                } else {
+                    append_line_data(&old_top, &old_last, old_lineno);
+                }
+            }
+        }
+        free_line_data(diff->line);
+        diff->line = old_top;
+    }
+}
+
+/**
+ * new line number -> baseline line number
+ * cur  : first block not passed yet (line numbers must go up)
+ * delta: baseline - new line number after the passed blocks
+ * 0: new line (not in baseline)
+ * >0: baseline line number
+ */
+static int remap_lineno(BLOCK_DATA **cur, int *delta, int lineno)
+{
+    BLOCK_DATA *b;
+
+    for (b = *cur; b; b = b->next) {
+        if (lineno < b->new_start) break;
+        if (lineno < b->new_start + b->new_count) return 0;
+        *delta = (b->old_start + b->old_count) - (b->new_start + b->new_count);
+        *cur = b->next;
+    }
+    return lineno + *delta;
+}
+
+/**
+ * append line number to line ranges (joined when continuous)
+ */
+static void append_line_data(LINE_DATA **top, LINE_DATA **last, int lineno)
+{
+    LINE_DATA *p;
+
+    if (*last != NULL && (*last)->end + 1 == lineno) {
+        (*last)->end = lineno;
+        return;
+    }
+    if ((p = (LINE_DATA *)malloc(sizeof(LINE_DATA))) == NULL) return;
+    memset(p, 0, sizeof(LINE_DATA));
+    p->start = p->end = lineno;
+    if (*top == NULL) *top = p;
+    else (*last)->next = p;
+    *last = p;
+}
+
+/**
+ * count lines of line ranges
+ */
+int dgc_count_line_data(LINE_DATA *p)
+{
+    int n = 0;
+
+    for (; p; p = p->next) n += p->end - p->start + 1;
+    return n;
+}
+
+/**
+ * parse diff line
+ * ex1. 30a31,32 -> start = 31, end = 32
+ * ex2. 22,30d22 -> start = 22, end = 22
+ */
+static void parse_diff_lineno(char *line, int *start, int *end)
+{
+    int i;
+    char *start_p, *end_p;
+
+    for (i = 0; i < strlen(line); i++) {
+        if (line[i] == 'a' || line[i] == 'c') {
+            start_p = line+i+1;
+            end_p = strchr(start_p, ',');
+            if (end_p != NULL) {
+                end_p++;
+            } else {
+                end_p =start_p;
+            }
+            *start = atoi(start_p);
+	        *end   = atoi(end_p);
+            break;
+        }
+    }
+    return;
+}
+
+/**
+ * diff data memory free
+ */
+void dgc_free_diff_data(DIFF_DATA *p)
+{
+    DIFF_DATA *p_next;
+
+    for (; p; p = p_next) {
+        free_line_data(p->line);
+        free_line_data(p->unknown); /* 20261018 */
+        p_next = p->next;
+        free(p);
+    }
+}
+
+/**
+ * line data memory free
+ */
+static void free_line_data(LINE_DATA *p)
+{
+    LINE_DATA *p_next;
+
+    for (; p; p = p_next) {
+        p_next = p->next;
+        free(p);
+    }
+}
+
+/**
+ * file read line , next line
+ * 0: ok, -1: eof
+ */
+static int readline(char *buf, READ_BUF *p, FILE *fp)
+{
+    /* crnt -> prev copy */
+    memcpy(p->prev, p->crnt, sizeof(p->crnt));
+    memset(p->crnt, 0, sizeof(p->crnt));
+
+    /* next -> crnt copy */
+    memcpy(p->crnt, p->next, sizeof(p->next));
+    memset(p->next, 0, sizeof(p->next));
+
+    if (p->crnt[0] == '\0') {
+        if (fgets(p->crnt, sizeof(p->crnt)-1, fp) == NULL) {
+            return -1; /* eof */
+        }
+        cut_LF(p->crnt);
+    }
+    if (p->next[0] == '\0') {
+        if (fgets(p->next, sizeof(p->next)-1, fp) == NULL) {
+            /* next readline is eof */
+        }
+        cut_LF(p->next);
+    }
+    memcpy(buf, p->crnt, strlen(p->crnt));
+    return 0;
+}
+
+/**
+ * cut LF
+ */
+static void cut_LF(char *p)
+{
+    if (p[strlen(p)-1] == '\n') {
+        p[strlen(p)-1] = '\0';
+    }
+}
+/*************** parallel diff parsing (add 20261018) **************/
+/**
+ * create diff data on multiple threads
+ * the mapped diff file is split at section heads and every section is
+ * parsed by create_diff_data_fp(), then joined in file order.
+ * 0: ok
+ * -1: not done (caller falls back to serial parsing)
+ */
+static int create_diff_data_parallel(char *file, int fmt, int jobs, DIFF_DATA **top)
+{
+    int fd, i, nthread, ret;
+    struct stat st;
+    char *map;
+    unsigned long *offs;
+    DIFF_SECTION *sect;
+    DIFF_WORKER worker;
+    pthread_t *th;
+    DIFF_DATA *p_prev, *p;
+
+    if ((fd = open(file, O_RDONLY)) < 0) return -1;
+    if (fstat(fd, &st) < 0 || st.st_size < PARALLEL_DIFF_MINSZ) { close(fd); return -1; }
+    map = (char *)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
+
+    offs = NULL;
+    worker.nsect = scan_diff_sections(map, st.st_size, fmt, &offs);
+    if (worker.nsect < 2 || (sect = (DIFF_SECTION *)calloc(worker.nsect, sizeof(DIFF_SECTION))) == NULL) {
+        free(offs);
+        munmap(map, st.st_size);
+        return -1;
+    }
+    for (i = 0; i < worker.nsect; i++) {
+        sect[i].top = map + offs[i];
+        sect[i].sz = (i+1 < worker.nsect ? offs[i+1] : st.st_size) - offs[i];
+    }
+    free(offs);
+    worker.sect = sect;
+    worker.fmt = fmt;
+    worker.next = 0;
+
+    nthread = jobs < worker.nsect ? jobs : worker.nsect;
+    if ((th = (pthread_t *)calloc(nthread, sizeof(pthread_t))) == NULL) nthread = 1;
+    for (i = 1; i < nthread; i++) {
+        if (pthread_create(&th[i], NULL, diff_section_worker, &worker) != 0) break;
+    }
+    nthread = i;
+    diff_section_worker(&worker); /* main thread works, too */
+    for (i = 1; i < nthread; i++) pthread_join(th[i], NULL);
+    free(th);
+    munmap(map, st.st_size);
+
+    ret = 0;
+    for (i = 0; i < worker.nsect; i++) {
+        if (sect[i].err) ret = -1;
+    }
+    p_prev = NULL;
+    for (i = 0; i < worker.nsect; i++) {
+        if (ret != 0) { dgc_free_diff_data(sect[i].diff); continue; }
+        if (sect[i].diff == NULL) continue;
+        if (p_prev == NULL) *top = sect[i].diff;
+        else p_prev->next = sect[i].diff;
+        for (p = sect[i].diff; p; p = p->next) p_prev = p;
+    }
+    free(sect);
+    return ret;
+}
+
+/**
+ * diff section parse thread
+ */
+static void *diff_section_worker(void *arg)
+{
+    DIFF_WORKER *w = (DIFF_WORKER *)arg;
+    DIFF_SECTION *s;
+    FILE *fp;
+    int i;
+
+    while ((i = __sync_fetch_and_add(&w->next, 1)) < w->nsect) {
+        s = &w->sect[i];
+        if ((fp = fmemopen(s->top, s->sz, "r")) == NULL) { s->err = 1; continue; }
+        create_diff_data_fp(fp, w->fmt, &s->diff);
+        fclose(fp);
+    }
+    return NULL;
+}
+
+/**
+ * scan section head offsets of mapped diff file
+ * (fmt is dispatched here once)
+ * >=1: section count (offs[0] is always top of file)
+ * -1: error
+ */
+static int scan_diff_sections(char *top, unsigned long sz, int fmt, unsigned long **offs)
+{
+    switch (fmt) {
+    case DGC_CVS_FMT: return scan_diff_sections_t<CVS_PARSER>(top, sz, offs);
+    case DGC_DIFF_FMT: return scan_diff_sections_t<DIFFALL_PARSER>(top, sz, offs);
+    case DGC_SVN_FMT: return scan_diff_sections_t<SVN_PARSER>(top, sz, offs);
+    case DGC_GIT_FMT: return scan_diff_sections_t<GIT_PARSER>(top, sz, offs);
+    }
+    *offs = NULL;
+    return -1;
+}
+
+/**
+ * scan section head offsets (per format)
+ * lines are cut the same way as readline() (fgets with LINEBUFSZ),
+ * so every section starts where the serial parser would start it.
+ * a head just after an empty line is not split, because readline()
+ * skips the empty line and the serial parser may read the head as
+ * section body.
+ */
+template <class FMT> static int scan_diff_sections_t(char *top, unsigned long sz, unsigned long **offs)
+{
+    unsigned long s_pos, e_pos, max;
+    int n, prev_blank;
+    unsigned long *tmp;
+
+    max = 64;
+    if ((*offs = (unsigned long *)malloc(sizeof(unsigned long) * max)) == NULL) return -1;
+    (*offs)[0] = 0;
+    n = 1;
+
+    prev_blank = 1;
+    for (s_pos = 0; s_pos < sz; s_pos = e_pos) {
+        for (e_pos = s_pos; e_pos < sz && e_pos - s_pos < LINEBUFSZ - 2; ) {
+            if (top[e_pos++] == '\n') break;
+        }
+        if (s_pos > 0 && !prev_blank && FMT::is_head(top, s_pos, e_pos, sz)) {
+            if (n == max) {
+                if ((tmp = (unsigned long *)realloc(*offs, sizeof(unsigned long) * max * 2)) == NULL) return -1;
+                *offs = tmp;
+                max *= 2;
+            }
+            (*offs)[n++] = s_pos;
+        }
+        prev_blank = (top[s_pos] == '\n' || top[s_pos] == '\0');
+    }
+    return n;
+}
+
+/**
+ * search str in mapped line (stops at null)
+ * 1: found
+ * 0: not found
+ */
+static int mem_contains(char *top, unsigned long long s_pos, unsigned long long e_pos, const char *str)
+{
+    unsigned long long i, len = strlen(str);
+
+    for (i = s_pos; i + len <= e_pos; i++) {
+        if (top[i] == '\0') break;
+        if (memcmp(top + i, str, len) == 0) return 1;
+    }
+    return 0;
+}
+
+/*************** diff list -> gcov list **************/
+
+/**
+ * create gcov file with diff merge, and create gcov data list
+ * (all .gcov files are opened and mapped at once by io_batch, and
+ *  parsed in diff order as soon as each one arrives 20261018)
+ * the mapping is handed to the gcov data as its linebuf, and the
+ * records are referred in place (20261018).
+ * stream != NULL: each gcov data is handed to stream_gcov() instead
+ * of being linked to top.
+ */
+void dgc_create_gcov_data(DIFF_DATA *diff, GCOV_DATA **top, int jobs, GCOV_STREAM *stream)
+{
+    DIFF_DATA *d;
+    GCOV_DATA *p, *p_prev;
+    IO_BATCH batch;
+    IO_REQ *req;
+    int i, n;
+
+    for (n = 0, d = diff; d; d = d->next) n++;
+    if ((req = (IO_REQ *)calloc(n, sizeof(IO_REQ))) == NULL) return;
+    for (i = 0, d = diff; d; d = d->next, i++) {
+        snprintf(req[i].path, sizeof(req[i].path), "%s.gcov", d->src);
+        req[i].flags = IO_MAP;
+    }
+    io_batch_submit(&batch, req, n, jobs);
+
+    for (i = 0; diff; diff = diff->next, i++) {
+
+        if ((p = (GCOV_DATA *)malloc(sizeof(GCOV_DATA))) == NULL) break;
+        memset(p, 0, sizeof(GCOV_DATA));
+
+        snprintf(p->gcov, sizeof(p->gcov), "%s.gcov", diff->src); /* 20261018 */
+        p->unknown = diff->unknown; /* 20261018 */
+        p->line_unknown = dgc_count_line_data(diff->unknown);
+
+        io_batch_wait(&batch, i);
+        if (req[i].err) { io_batch_release(&batch, i); free(p); continue; }
+
+        p->linebuf.top = req[i].buf; /* 20261018 */
+        p->linebuf.max = p->linebuf.pos = req[i].sz;
+        p->linebuf.mapped = 1;
+        req[i].buf = NULL;
+        io_batch_release(&batch, i);
+        create_gcov_line_data(p, diff->line);
+
+        if (stream) { /* 20261018 */
+            stream_gcov(stream, p);
+        } else if (*top == NULL) {
+            *top = p;
+            p_prev = p;
+        } else {
+            p_prev->next = p;
+            p_prev = p;
+        }
+    }
+
+    io_batch_finish(&batch);
+    free(req);
+}
+
+/**
+ * create gcov line data with diff merge (one gcov file)
+ * (split from create_gcov_data 20261018)
+ * the lines of p->linebuf are read from its refpos, and only their
+ * positions are kept. (no copy, no line length limit 20261018)
+ * template and inline functions have instance blocks after their
+ * lines, which repeat the same line numbers. the changed lines are
+ * found by line number index, and the branches and conditions of the
+ * blocks are joined to them in the same pass. (20261018)
+ * ex)         2:    3:    if (a > b)   <- lines (count of all instances)
+ *     ------------------
+ *     _Z3addIiET_S0_S0_:
+ *             1:    3:    if (a > b)
+ *     branch  0 taken 0% (fallthrough)
+ */
+static void create_gcov_line_data(GCOV_DATA *p, LINE_DATA *line)
+{
+    GCOV_LINE_BUF *buf = &p->linebuf;
+    int lineno;
+    GCOV_LINE_DATA *pl, *pl_prev, *cur;
+    GCOV_LINE_INDEX index;
+    GCOV_INST_SCAN is;
+    GCOV_FUNC_SCAN fs;
+    unsigned long long s_pos, e_pos;
+    char countbuf[32];
+    char c;
+    int exec;
+
+    memset(&fs, 0, sizeof(fs));
+    memset(&is, 0, sizeof(is));
+    memset(&index, 0, sizeof(index));
+    cur = NULL; /* line of branch and condition records */
+    while (gcov_line_next(buf, &s_pos, &e_pos)) { /* 20110210 */
+        scan_gcov_func(&fs, buf, s_pos, e_pos); /* 20261018 */
+
+        c = buf->top[s_pos];
+        if (is_gcov_inst_separator(buf, s_pos, e_pos)) { /* 20261018 */
+            flush_gcov_inst_cond(buf, cur, &is);
+            cur = NULL;
+            is.sep = 1;
+            is.inst = 0;
+            continue;
+        }
+        if (is.sep && c != ' ' && buf->top[e_pos-1] == ':') { /* instance name */
+            is.sep = 0;
+            is.inst = 1;
+            is.name_s = s_pos;
+            is.name_e = e_pos - 1;
+            continue;
+        }
+        is.sep = 0;
+        if (isalpha(c)) { /* function, branch, call, condition ... */
+            if (line == NULL && !is.inst && is_gcov_func_record(buf, s_pos, e_pos)) break; /* instances of changed lines are read */
+            if (cur == NULL) continue;
+            if (c == 'b' && mem_contains(buf->top, s_pos, e_pos, "branch")) {
+                if (!is.inst) {
+                    if (append_gcov_branch_pos(&cur->branch, s_pos, e_pos) != 0) break;
+                } else {
+                    if (merge_gcov_branch_pos(buf, &cur->branch, is.nbranch++, is.count, s_pos, e_pos) != 0) break;
+                    if (is_gcov_branch_pass(buf, s_pos, e_pos)) is.pi->branch_pass++;
+                    else is.pi->branch_notpass++;
+                }
+            } else if (is_gcov_cond_record(buf, s_pos, e_pos)) { /* 20261018 */
+                if (append_gcov_branch_pos(is.inst ? &is.cond : &cur->cond, s_pos, e_pos) != 0) break;
+            }
+            continue;
+        }
+
+        flush_gcov_inst_cond(buf, cur, &is);
+        cur = NULL;
+        if ((lineno = gcov_line_lineno(buf, s_pos, e_pos)) < 0) continue;
+        if (is.inst) { /* 20261018 */
+            if ((cur = find_gcov_line_index(&index, lineno)) == NULL) continue;
+            add_gcov_func(&fs, p, lineno, is_gcov_line_exec(buf, s_pos, e_pos));
+            if ((is.pi = append_gcov_inst_data(cur, is.name_s, is.name_e, s_pos, e_pos)) == NULL) { cur = NULL; break; }
+            is.nbranch = 0;
+            memset(countbuf, 0, sizeof(countbuf));
+            dgc_gcov_line_get_by_pos(buf, countbuf, sizeof(countbuf)-1, s_pos, e_pos);
+            is.count = parse_gcov_count(countbuf, &exec);
+            continue;
+        }
+        while (line && line->end < lineno) line = line->next;
+        if (line == NULL || lineno < line->start) continue;
+
+        /* -- add 20110210 */
+        if ((pl = (GCOV_LINE_DATA *)malloc(sizeof(GCOV_LINE_DATA))) == NULL) break;
+        memset(pl, 0, sizeof(GCOV_LINE_DATA));
+        pl->s_pos = s_pos;
+        pl->e_pos = e_pos;
+        pl->lineno = lineno;
+        add_gcov_func(&fs, p, lineno, is_gcov_line_exec(buf, s_pos, e_pos)); /* 20261018 */
+        if (p->line == NULL) {
+            p->line = pl;
+            pl_prev = pl;
+        } else {
+            pl_prev->next = pl;
+            pl_prev = pl;
+        }
+        /* -- add 20110210 */
+        add_gcov_line_index(&index, pl); /* 20261018 */
+        cur = pl;
+    }
+    flush_gcov_inst_cond(buf, cur, &is);
+    free(index.line);
+    join_gcov_inst_data(p); /* 20261018 */
+}
+
+/**
+ * scan function records (add 20261018)
+ * the records of a function come before its first line. they are kept
+ * until the next records, with the lines read after them (start-end).
+ * ex) function f called 1 returned 100% blocks executed 88%
+ */
+static void scan_gcov_func(GCOV_FUNC_SCAN *fs, GCOV_LINE_BUF *buf, unsigned long long s_pos, unsigned long long e_pos)
+{
+    int lineno;
+
+    if (is_gcov_func_record(buf, s_pos, e_pos)) {
+        if (fs->line) {
+            fs->n = 0;
+            fs->added = 0;
+            fs->line = 0;
+        }
+        if (fs->n < FUNC_PENDING_MAX) {
+            fs->s_pos[fs->n] = s_pos;
+            fs->e_pos[fs->n] = e_pos;
+            fs->n++;
+        }
+    } else if (fs->n > 0 && buf->top[s_pos] == ' ' && memchr(buf->top + s_pos, ':', e_pos - s_pos)) {
+        if ((lineno = gcov_line_lineno(buf, s_pos, e_pos)) <= 0) return;
+        if (!fs->line) fs->start = fs->end = lineno;
+        if (lineno > fs->end) fs->end = lineno; /* instance blocks repeat the lines */
+        fs->line = 1;
+    }
+}
+
+/**
+ * add function records of current function to gcov data (add 20261018)
+ * called for a changed line, so only functions overlapping the
+ * changed ranges are added (once per function).
+ * the line must be executable and in the lines of the function, so
+ * blank lines and comments between functions add nothing.
+ */
+static void add_gcov_func(GCOV_FUNC_SCAN *fs, GCOV_DATA *p, int lineno, int exec)
+{
+    GCOV_FUNC_DATA *pf, *pf_last;
+    int i;
+
+    if (fs->added || fs->n == 0 || !fs->line) return;
+    if (!exec || lineno < fs->start || lineno > fs->end) return;
+    fs->added = 1;
+
+    for (pf_last = p->func; pf_last && pf_last->next; pf_last = pf_last->next);
+    for (i = 0; i < fs->n; i++) {
+        if ((pf = (GCOV_FUNC_DATA *)malloc(sizeof(GCOV_FUNC_DATA))) == NULL) return;
+        memset(pf, 0, sizeof(GCOV_FUNC_DATA));
+        pf->s_pos = fs->s_pos[i];
+        pf->e_pos = fs->e_pos[i];
+        if (pf_last == NULL) p->func = pf;
+        else pf_last->next = pf;
+        pf_last = pf;
+    }
+}
+
+/**
+ * check gcov function record (add 20261018)
+ * 1: function record
+ * 0: not
+ */
+static int is_gcov_func_record(GCOV_LINE_BUF *buf, unsigned long long s_pos, unsigned long long e_pos)
+{
+    return e_pos - s_pos > 9 && memcmp(buf->top + s_pos, "function ", 9) == 0
+        && mem_contains(buf->top, s_pos, e_pos, " called ");
+}
+
+/**
+ * check executable gcov line (add 20261018)
+ * ex)         5:   10:    y += i;   <- executable
+ *         #####:   11:    y -= i;   <- executable
+ *             -:   12:}             <- not
+ * 1: executable
+ * 0: not
+ */
+static int is_gcov_line_exec(GCOV_LINE_BUF *buf, unsigned long long s_pos, unsigned long long e_pos)
+{
+    char *c;
+
+    if ((c = (char *)memchr(buf->top + s_pos, ':', e_pos - s_pos)) == NULL || c == buf->top + s_pos) return 0;
+    return *(c-1) != '-';
+}
+
+/**
+ * check gcov condition record (add 20261018)
+ * gcc 14 -fcondition-coverage, gcov --conditions
+ * ex) condition outcomes covered 1/4
+ *     condition  0 not covered (true false)
+ * 1: condition record
+ * 0: not
+ */
+static int is_gcov_cond_record(GCOV_LINE_BUF *buf, unsigned long long s_pos, unsigned long long e_pos)
+{
+    return e_pos - s_pos > 10 && memcmp(buf->top + s_pos, "condition ", 10) == 0;
+}
+
+/**
+ * get call count of function record (add 20261018)
+ * only the part after the name is copied, as a mangled name can be
+ * longer than LINEBUFSZ.
+ */
+unsigned long long dgc_gcov_func_called(GCOV_LINE_BUF *buf, GCOV_FUNC_DATA *pf)
+{
+    char linebuf[64];
+    char *c;
+
+    if (buf->top == NULL) return 0;
+    if ((c = (char *)memmem(buf->top + pf->s_pos, pf->e_pos - pf->s_pos, " called ", 8)) == NULL) return 0;
+    memset(linebuf, 0, sizeof(linebuf));
+    dgc_gcov_line_get_by_pos(buf, linebuf, sizeof(linebuf)-1, c - buf->top, pf->e_pos);
+    return parse_func_called(linebuf);
+}
+
+/**
+ * copy gcov line and append its position to the list (add 20261018)
+ * (split from create_gcov_line_data)
+ * 0: ok
+ * -1: error
+ */
+static int append_gcov_branch_data(GCOV_LINE_BUF *linebuf, GCOV_BRANCH_DATA **top, char *line)
+{
+    unsigned long long s_pos, e_pos;
+
+    if (gcov_line_data_copy(linebuf, line, strlen(line), &s_pos, &e_pos) == 0) return -1;
+    return append_gcov_branch_pos(top, s_pos, e_pos);
+}
+
+/**
+ * append gcov line position to the list (add 20261018)
+ * 0: ok
+ * -1: error
+ */
+static int append_gcov_branch_pos(GCOV_BRANCH_DATA **top, unsigned long long s_pos, unsigned long long e_pos)
+{
+    GCOV_BRANCH_DATA *pb, *pb_last;
+
+    if ((pb = (GCOV_BRANCH_DATA *)malloc(sizeof(GCOV_BRANCH_DATA))) == NULL) return -1;
+    memset(pb, 0, sizeof(GCOV_BRANCH_DATA));
+    pb->s_pos = s_pos;
+    pb->e_pos = e_pos;
+    for (pb_last = *top; pb_last && pb_last->next; pb_last = pb_last->next);
+    if (pb_last == NULL) *top = pb;
+    else pb_last->next = pb;
+    return 0;
+}
+
+/**
+ * check separator of template instance blocks (add 20261018)
+ * ex) ------------------
+ * 1: separator
+ * 0: not
+ */
+static int is_gcov_inst_separator(GCOV_LINE_BUF *buf, unsigned long long s_pos, unsigned long long e_pos)
+{
+    unsigned long long i;
+
+    if (e_pos - s_pos < 10) return 0;
+    for (i = s_pos; i < e_pos; i++) {
+        if (buf->top[i] != '-') return 0;
+    }
+    return 1;
+}
+
+/**
+ * check branch record is taken (add 20261018)
+ * 1: taken
+ * 0: 0% or never executed
+ */
+static int is_gcov_branch_pass(GCOV_LINE_BUF *buf, unsigned long long s_pos, unsigned long long e_pos)
+{
+    return !mem_contains(buf->top, s_pos, e_pos, " 0%") && !mem_contains(buf->top, s_pos, e_pos, "never");
+}
+
+/**
+ * merge branch record of template instance (add 20261018)
+ * (idx: branch number of the line in the block, count: count of the
+ *  line in the instance)
+ * the taken % of instances is summed with the line count as weight,
+ * and the joined record is written by join_gcov_inst_data().
+ * 0: ok
+ * -1: error
+ */
+static int merge_gcov_branch_pos(GCOV_LINE_BUF *buf, GCOV_BRANCH_DATA **top, int idx, unsigned long long count, unsigned long long s_pos, unsigned long long e_pos)
+{
+    char linebuf[LINEBUFSZ];
+    GCOV_BRANCH_DATA *pb;
+    int taken;
+
+    for (pb = *top; pb && idx > 0; pb = pb->next, idx--);
+    if (pb == NULL) {
+        if (append_gcov_branch_pos(top, s_pos, e_pos) != 0) return -1;
+        for (pb = *top; pb->next; pb = pb->next);
+    }
+    memset(linebuf, 0, sizeof(linebuf));
+    dgc_gcov_line_get_by_pos(buf, linebuf, sizeof(linebuf)-1, s_pos, e_pos);
+    if ((taken = parse_branch_taken(linebuf)) > 0) pb->taken_sum += taken * count;
+    pb->count_sum += count;
+    pb->ninst++;
+    return 0;
+}
+
+/**
+ * append template instance of changed line (add 20261018)
+ * NULL: error
+ */
+static GCOV_INST_DATA *append_gcov_inst_data(GCOV_LINE_DATA *pl, unsigned long long name_s, unsigned long long name_e, unsigned long long s_pos, unsigned long long e_pos)
+{
+    GCOV_INST_DATA *pi, *pi_last;
+
+    if ((pi = (GCOV_INST_DATA *)malloc(sizeof(GCOV_INST_DATA))) == NULL) return NULL;
+    memset(pi, 0, sizeof(GCOV_INST_DATA));
+    pi->name_s = name_s;
+    pi->name_e = name_e;
+    pi->s_pos = s_pos;
+    pi->e_pos = e_pos;
+    for (pi_last = pl->inst; pi_last && pi_last->next; pi_last = pi_last->next);
+    if (pi_last == NULL) pl->inst = pi;
+    else pi_last->next = pi;
+    return pi;
+}
+
+/**
+ * join conditions of template instance to changed line (add 20261018)
+ * an outcome is covered if any instance covered it. the blocks are
+ * joined by condition number as the shards of --merge, and the joined
+ * records are written by join_gcov_inst_data().
+ */
+static void flush_gcov_inst_cond(GCOV_LINE_BUF *buf, GCOV_LINE_DATA *pl, GCOV_INST_SCAN *is)
+{
+    char linebuf[LINEBUFSZ];
+    GCOV_BRANCH_DATA *pb;
+
+    if (is->cond == NULL) return;
+    if (pl != NULL && pl->join == NULL) pl->join = (MERGE_LINE *)calloc(1, sizeof(MERGE_LINE));
+    if (pl != NULL && pl->join != NULL) {
+        for (pb = is->cond; pb; pb = pb->next) {
+            memset(linebuf, 0, sizeof(linebuf));
+            if (dgc_gcov_line_get_by_pos(buf, linebuf, sizeof(linebuf)-1, pb->s_pos, pb->e_pos) == 0) break;
+            if (merge_gcov_cond(pl->join, linebuf) != 0) break;
+        }
+        merge_cond_flush(pl->join);
+    }
+    free_gcov_branch_data(is->cond);
+    is->cond = NULL;
+}
+
+/**
+ * write the records joined over template instances (add 20261018)
+ * the records are written to p->joined, as p->linebuf may be a file
+ * mapping. a branch of one instance is left as it is.
+ */
+static void join_gcov_inst_data(GCOV_DATA *p)
+{
+    GCOV_LINE_DATA *pl;
+    GCOV_BRANCH_DATA *pb;
+    MERGE_COND *mc;
+
+    for (pl = p->line; pl; pl = pl->next) {
+        for (pb = pl->branch; pb; pb = pb->next) {
+            if (pb->ninst > 1 && append_gcov_joined_branch(p, pb) != 0) break;
+        }
+        if (pl->join == NULL) continue;
+
+        free_gcov_branch_data(pl->cond);
+        pl->cond = NULL;
+        for (mc = pl->join->cond; mc; mc = mc->next) {
+            if (append_merge_cond(&p->joined, &pl->cond, mc) != 0) break;
+        }
+        for (pb = pl->cond; pb; pb = pb->next) pb->joined = 1;
+        free_merge_cond(pl->join->cond);
+        free(pl->join);
+        pl->join = NULL;
+    }
+}
+
+/**
+ * write joined branch record to p->joined (add 20261018)
+ * ex) branch  0 taken 100% (fallthrough) x1 + branch  0 taken 0% x1
+ *     -> branch  0 taken 50% (fallthrough)
+ * as gcov, 0% and 100% are only for none and all taken.
+ * 0: ok
+ * -1: error
+ */
+static int append_gcov_joined_branch(GCOV_DATA *p, GCOV_BRANCH_DATA *pb)
+{
+    char linebuf[LINEBUFSZ];
+    char *c, *rest;
+    int head, taken;
+
+    memset(linebuf, 0, sizeof(linebuf));
+    if (dgc_gcov_line_get_by_pos(dgc_gcov_branch_buf(p, pb), linebuf, sizeof(linebuf)-1, pb->s_pos, pb->e_pos) == 0) return -1;
+    if ((c = strstr(linebuf, "taken ")) == NULL && (c = strstr(linebuf, "never")) == NULL) return 0;
+    head = c - linebuf;
+    if ((rest = strchr(c, '%')) != NULL) rest++;
+    else if ((rest = strstr(c, "executed")) != NULL) rest += strlen("executed");
+    else rest = (char *)"";
+
+    if (pb->count_sum == 0) {
+        if (gcov_line_data_printf(&p->joined, &pb->s_pos, &pb->e_pos, "%.*snever executed%s", head, linebuf, rest) == 0) return -1;
+    } else {
+        taken = (int)((pb->taken_sum + pb->count_sum / 2) / pb->count_sum);
+        if (taken == 0 && pb->taken_sum > 0) taken = 1;
+        if (taken == 100 && pb->taken_sum < 100 * pb->count_sum) taken = 99;
+        if (gcov_line_data_printf(&p->joined, &pb->s_pos, &pb->e_pos, "%.*staken %d%%%s", head, linebuf, taken, rest) == 0) return -1;
+    }
+    pb->joined = 1;
+    return 0;
+}
+
+/**
+ * append condition records of joined outcomes (add 20261018)
+ * (split from create_gcov_data_merge)
+ * 0: ok
+ * -1: error
+ */
+static int append_merge_cond(GCOV_LINE_BUF *buf, GCOV_BRANCH_DATA **top, MERGE_COND *mc)
+{
+    char linebuf[LINEBUFSZ];
+    int i, covered;
+
+    for (covered = i = 0; i < mc->nterm; i++) covered += !(mc->mask[i] & 1) + !(mc->mask[i] & 2);
+    snprintf(linebuf, sizeof(linebuf), "condition outcomes covered %d/%d", covered, mc->nterm * 2);
+    if (append_gcov_branch_data(buf, top, linebuf) != 0) return -1;
+    for (i = 0; i < mc->nterm; i++) {
+        if (mc->mask[i] == 0) continue;
+        snprintf(linebuf, sizeof(linebuf), "condition %2d not covered (%s%s)", i,
+            (mc->mask[i] & 1) ? "true" : "", (mc->mask[i] & 2) ? ((mc->mask[i] & 1) ? " false" : "false") : "");
+        if (append_gcov_branch_data(buf, top, linebuf) != 0) return -1;
+    }
+    return 0;
+}
+
+/**
+ * buffer of branch or condition record (add 20261018)
+ */
+GCOV_LINE_BUF *dgc_gcov_branch_buf(GCOV_DATA *p, GCOV_BRANCH_DATA *pb)
+{
+    return pb->joined ? &p->joined : &p->linebuf;
+}
+
+/**
+ * add changed line to line number index (add 20261018)
+ * the lines are added in order of line number.
+ * 0: ok
+ * -1: error
+ */
+static int add_gcov_line_index(GCOV_LINE_INDEX *index, GCOV_LINE_DATA *pl)
+{
+    GCOV_LINE_DATA **tmp;
+
+    if (index->n == index->max) {
+        if ((tmp = (GCOV_LINE_DATA **)realloc(index->line, (index->max ? index->max * 2 : 64) * sizeof(GCOV_LINE_DATA *))) == NULL) return -1;
+        index->line = tmp;
+        index->max = index->max ? index->max * 2 : 64;
+    }
+    index->line[index->n++] = pl;
+    return 0;
+}
+
+/**
+ * find changed line by line number (add 20261018)
+ * NULL: not changed line
+ */
+static GCOV_LINE_DATA *find_gcov_line_index(GCOV_LINE_INDEX *index, int lineno)
+{
+    int lo = 0, hi = index->n - 1, mid;
+
+    while (lo <= hi) {
+        mid = (lo + hi) / 2;
+        if (index->line[mid]->lineno == lineno) return index->line[mid];
+        if (index->line[mid]->lineno < lineno) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return NULL;
+}
+
+/**
+ * check gcov --conditions option (gcc 14) (add 20261018)
+ * 1: supported
+ * 0: not
+ */
+int dgc_gcov_has_conditions(void)
+{
+    char linebuf[LINEBUFSZ];
+    FILE *fp;
+    int found = 0;
+
+    fflush(stdout);
+    if ((fp = popen(GCOV_COMMAND " --help 2>/dev/null", "r")) == NULL) return 0;
+    while (fgets(linebuf, sizeof(linebuf), fp)) {
+        if (strstr(linebuf, "--conditions")) found = 1;
+    }
+    pclose(fp);
+    return found;
+}
+
+/**
+ * create gcov data from gcov --stdout (add 20261018)
+ * gcov is run once per object of the sources in diff, without shell.
+ * no .gcov file is created or read.
+ * up to jobs gcov processes run at once, and all their outputs are read
+ * as they come, so no process waits on a full pipe. the output of the
+ * first running object is parsed section by section as its lines come;
+ * the outputs of the next objects are kept until their turn, so the
+ * data is made in order of the objects.
+ * a header is in the output of every object including it, and its
+ * counts are summed over the objects in the same way as --merge.
+ * 0: ok
+ * -1: error
+ */
+int dgc_create_gcov_data_pipe(DIFF_DATA *diff, GCOV_DATA **top, int level, int jobs, GCOV_STREAM *stream)
+{
+    DIFF_DATA *d, **objs;
+    GCOV_DATA *p, *p_prev;
+    GCOV_PIPE gp;
+    int i, j, nobj, head, tail, branch, cond, ret;
+
+    branch = (level == DGC_ALL_LEVEL || level == DGC_C1_BRANCH_LEVEL);
+    cond = (level == DGC_ALL_LEVEL && dgc_gcov_has_conditions());
+    if (jobs < 1) jobs = 1;
+
+    memset(&gp, 0, sizeof(GCOV_PIPE));
+    gp.stream = stream;
+    for (gp.n = 0, d = diff; d; d = d->next) gp.n++;
+    gp.diffs = (DIFF_DATA **)calloc(gp.n + 1, sizeof(DIFF_DATA *));
+    objs = (DIFF_DATA **)calloc(gp.n + 1, sizeof(DIFF_DATA *));
+    gp.gcovs = (GCOV_DATA **)calloc(gp.n + 1, sizeof(GCOV_DATA *));
+    gp.merges = (MERGE_FILE **)calloc(gp.n + 1, sizeof(MERGE_FILE *));
+    gp.out = (GCOV_PIPE_OUT *)calloc(gp.n + 1, sizeof(GCOV_PIPE_OUT));
+    gp.pfd = (struct pollfd *)calloc(jobs, sizeof(struct pollfd));
+    if (gp.diffs == NULL || objs == NULL || gp.gcovs == NULL || gp.merges == NULL || gp.out == NULL || gp.pfd == NULL) {
+        printf("!!! gcov pipe of %d sources can not allocate !!!\n", gp.n);
+        free(gp.diffs); free(objs); free(gp.gcovs); free(gp.merges); free(gp.out); free(gp.pfd);
+        return -1;
+    }
+
+    /* one gcov process per object (headers come with the objects) */
+    nobj = 0;
+    for (i = 0, d = diff; d; d = d->next, i++) {
+        gp.diffs[i] = d;
+        if (strlen(d->src) == 0 || is_header_file(d->src)) continue;
+        for (j = 0; j < nobj; j++) {
+            if (strcmp(objs[j]->src, d->src) == 0) break;
+        }
+        if (j == nobj) objs[nobj++] = d;
+    }
+
+    for (head = tail = 0; head < nobj; head++) {
+        for (; tail < nobj && tail - head < jobs; tail++) {
+            gp.out[tail].fd = gcov_spawn(objs[tail]->src, branch, cond, &gp.out[tail].pid);
+        }
+        if (gcov_pipe_read(&gp, head, tail) != 0) break;
+        if (gp.out[head].pid > 0) waitpid(gp.out[head].pid, NULL, 0);
+        gcov_line_free(&gp.out[head].buf);
+    }
+    ret = 0;
+    if (head < nobj) { /* error: the running processes end on the closed pipes */
+        for (i = head; i < tail; i++) {
+            if (gp.out[i].fd >= 0) close(gp.out[i].fd);
+            if (gp.out[i].pid > 0) waitpid(gp.out[i].pid, NULL, 0);
+            gcov_line_free(&gp.out[i].buf);
+        }
+        ret = -1;
+    }
+
+    /* headers are done after all objects */
+    for (i = 0; i < gp.n; i++) {
+        if (gp.merges[i] == NULL) continue;
+        if (ret == 0 && (p = dgc_create_gcov_data_merge(gp.merges[i])) != NULL) {
+            p->unknown = gp.diffs[i]->unknown;
+            p->line_unknown = dgc_count_line_data(gp.diffs[i]->unknown);
+            gp.gcovs[i] = p;
+            if (stream) stream_gcov(stream, p);
+        }
+        dgc_free_merge_data(gp.merges[i]);
+    }
+
+    p_prev = NULL;
+    for (i = 0; i < gp.n && stream == NULL; i++) {
+        if (gp.gcovs[i] == NULL) continue;
+        if (ret != 0) { dgc_free_gcov_data(gp.gcovs[i]); continue; }
+        if (p_prev == NULL) *top = gp.gcovs[i];
+        else p_prev->next = gp.gcovs[i];
+        p_prev = gp.gcovs[i];
+    }
+    free(gp.diffs);
+    free(objs);
+    free(gp.gcovs);
+    free(gp.merges);
+    free(gp.out);
+    free(gp.pfd);
+    return ret;
+}
+
+/**
+ * start gcov of the object of source (add 20261018)
+ * gcov is run without shell, and the .gcno path always starts with
+ * "./" or "/", so no name in diff is taken as command or option.
+ * ex) src/foo.c -> /usr/bin/gcov -b -t ./src/foo.gcno 2>/dev/null
+ * >=0: read end of gcov stdout
+ * -1: error
+ */
+static int gcov_spawn(char *src, int branch, int cond, pid_t *pid)
+{
+    char base[FILENAMESZ];
+    char gcno[FILENAMESZ + 16];
+    char *argv[8];
+    int fd[2], null, n = 0;
+
+    *pid = 0;
+    memset(base, 0, sizeof(base));
+    strncpy(base, src, sizeof(base)-1);
+    if (strrchr(base, '.')) *strrchr(base, '.') = 0;
+    snprintf(gcno, sizeof(gcno), "%s%s.gcno", base[0] == '/' ? "" : "./", base);
+
+    argv[n++] = (char *)GCOV_COMMAND;
+    if (branch) argv[n++] = (char *)"-b";
+    if (cond) argv[n++] = (char *)"--conditions";
+    argv[n++] = (char *)"-t";
+    argv[n++] = gcno;
+    argv[n] = NULL;
+
+    if (pipe2(fd, O_CLOEXEC) != 0) return -1;
+    fflush(stdout);
+    if ((*pid = fork()) < 0) {
+        *pid = 0;
+        close(fd[0]);
+        close(fd[1]);
+        return -1;
+    }
+    if (*pid == 0) {
+        dup2(fd[1], STDOUT_FILENO);
+        if ((null = open("/dev/null", O_WRONLY)) >= 0) dup2(null, STDERR_FILENO);
+        execv(GCOV_COMMAND, argv);
+        _exit(127);
+    }
+    close(fd[1]);
+    return fd[0];
+}
+
+/**
+ * read gcov outputs until the process of head ends (add 20261018)
+ * all running processes (head..tail-1) are read at once. the output of
+ * head is parsed as it comes, the others are kept in their buffers.
+ * the fd is closed and set -1 at the end of its output.
+ * 0: ok
+ * -1: error (fds of head..tail-1 are left to the caller)
+ */
+static int gcov_pipe_read(GCOV_PIPE *gp, int head, int tail)
+{
+    char linebuf[LINEBUFSZ];
+    GCOV_PIPE_OUT *o;
+    unsigned long long s_pos, e_pos;
+    ssize_t sz;
+    int i, k, npfd;
+
+    gcov_pipe_parse(gp, &gp->out[head], 0); /* read before its turn */
+    while (gp->out[head].fd >= 0) {
+        for (npfd = 0, k = head; k < tail; k++) {
+            if (gp->out[k].fd < 0) continue;
+            gp->pfd[npfd].fd = gp->out[k].fd;
+            gp->pfd[npfd].events = POLLIN;
+            gp->pfd[npfd].revents = 0;
+            npfd++;
+        }
+        if (poll(gp->pfd, npfd, -1) < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        for (i = 0, k = head; k < tail; k++) {
+            o = &gp->out[k];
+            if (o->fd < 0) continue;
+            if (gp->pfd[i++].revents == 0) continue;
+            sz = read(o->fd, linebuf, sizeof(linebuf));
+            if (sz < 0 && errno == EINTR) continue;
+            if (sz > 0) {
+                if (gcov_line_data_copy(&o->buf, linebuf, sz, &s_pos, &e_pos) == 0) {
+                    printf("!!! gcov output of %llu bytes can not allocate !!!\n", o->buf.pos + sz);
+                    return -1;
+                }
+                if (k == head) gcov_pipe_parse(gp, o, 0);
+                continue;
+            }
+            close(o->fd); /* end of output or error */
+            o->fd = -1;
+        }
+    }
+    if (gp->out[head].fd >= 0) {
+        close(gp->out[head].fd);
+        gp->out[head].fd = -1;
+    }
+    gcov_pipe_parse(gp, &gp->out[head], 1);
+    return 0;
+}
+
+/**
+ * parse the complete sections of one gcov output (add 20261018)
+ * a section ("0:Source:" head line and its lines) is complete when the
+ * next head line comes, or at eof. the last line may be cut before eof,
+ * so only the lines up to the last \n are checked. the parsed lines
+ * are dropped from the buffer.
+ */
+static void gcov_pipe_parse(GCOV_PIPE *gp, GCOV_PIPE_OUT *o, int eof)
+{
+    GCOV_LINE_BUF *buf = &o->buf;
+    unsigned long long end, e_pos, base;
+    char *c;
+
+    if (buf->top == NULL) return;
+    end = buf->pos;
+    if (!eof) {
+        if ((c = (char *)memrchr(buf->top + o->scan, '\n', buf->pos - o->scan)) == NULL) return;
+        end = c - buf->top + 1;
+    }
+    while (o->scan < end) {
+        c = (char *)memchr(buf->top + o->scan, '\n', end - o->scan);
+        e_pos = c ? (unsigned long long)(c - buf->top) : end;
+        if (is_gcov_source_head(buf, o->scan, e_pos)) {
+            if (o->open) create_gcov_data_section(gp, buf, o->sect, o->scan);
+            o->sect = o->scan;
+            o->open = 1;
+        }
+        o->scan = c ? e_pos + 1 : end;
+    }
+    if (eof && o->open) {
+        create_gcov_data_section(gp, buf, o->sect, end);
+        o->open = 0;
+    }
+
+    base = o->open ? o->sect : o->scan;
+    if (base == 0) return;
+    memmove(buf->top, buf->top + base, buf->pos - base);
+    buf->pos -= base;
+    buf->top[buf->pos] = 0;
+    buf->refpos = 0;
+    o->scan -= base;
+    if (o->open) o->sect -= base;
+}
+
+/**
+ * parse one section of gcov --stdout output (add 20261018)
+ * buf: sect is the "0:Source:" head line, and the section ends at end.
+ * a section that matches a diff source is copied to the gcov data, and
+ * parsed into gcovs[] (same index as diffs[]).
+ * a header section is merged into merges[] instead, as the header
+ * comes again with the other objects.
+ * stream != NULL: the parsed data is handed to stream_gcov() at once,
+ * and only its counters stay in gcovs[].
+ */
+static void create_gcov_data_section(GCOV_PIPE *gp, GCOV_LINE_BUF *buf, unsigned long long sect, unsigned long long end)
+{
+    char src[FILENAMESZ];
+    GCOV_DATA *p;
+    unsigned long long s_pos, e_pos, len;
+    char *c;
+    int i, header;
+
+    c = (char *)memchr(buf->top + sect, '\n', end - sect);
+    e_pos = c ? (unsigned long long)(c - buf->top) : end;
+    c = (char *)memmem(buf->top + sect, e_pos - sect, "Source:", 7) + 7;
+    memset(src, 0, sizeof(src));
+    len = buf->top + e_pos - c;
+    memcpy(src, c, len < sizeof(src) ? len : sizeof(src)-1);
+    for (i = 0; i < gp->n; i++) {
+        if (!is_same_source(src, gp->diffs[i]->src)) continue;
+        if (is_header_file(gp->diffs[i]->src) || gp->gcovs[i] == NULL) break;
+    }
+    if (i == gp->n) return;
+    header = is_header_file(gp->diffs[i]->src);
+    sect = e_pos < end ? e_pos + 1 : end; /* lines after the head */
+
+    if ((p = (GCOV_DATA *)malloc(sizeof(GCOV_DATA))) == NULL) return;
+    memset(p, 0, sizeof(GCOV_DATA));
+    snprintf(p->gcov, sizeof(p->gcov), "%s.gcov", gp->diffs[i]->src);
+    p->unknown = gp->diffs[i]->unknown;
+    p->line_unknown = dgc_count_line_data(gp->diffs[i]->unknown);
+    if (end > sect) gcov_line_data_copy(&p->linebuf, buf->top + sect, end - sect, &s_pos, &e_pos);
+    create_gcov_line_data(p, gp->diffs[i]->line);
+    if (header) {
+        merge_gcov_data(&gp->merges[i], p);
+        dgc_free_gcov_data(p);
+        return;
+    }
+    gp->gcovs[i] = p;
+    if (gp->stream) stream_gcov(gp->stream, p); /* 20261018 */
+}
+
+/**
+ * check gcov source head line (add 20261018)
+ * ex)         -:    0:Source:foo.c
+ * 1: head
+ * 0: not head
+ */
+static int is_gcov_source_head(GCOV_LINE_BUF *buf, unsigned long long s_pos, unsigned long long e_pos)
+{
+    if (buf->top[s_pos] != ' ') return 0;
+    return mem_contains(buf->top, s_pos, e_pos, ":    0:Source:");
+}
+
+/**
+ * compare gcov source name with diff source name (add 20261018)
+ * ex) "../src/foo.c" and "src/foo.c" are same
+ * 1: same
+ * 0: not same
+ */
+static int is_same_source(char *gcov_src, char *diff_src)
+{
+    unsigned long gl, dl;
+
+    if (strcmp(gcov_src, diff_src) == 0) return 1;
+    gl = strlen(gcov_src);
+    dl = strlen(diff_src);
+    if (gl > dl && gcov_src[gl-dl-1] == '/' && strcmp(gcov_src + gl - dl, diff_src) == 0) return 1;
+    return 0;
+}
+
+/**
+ * check header file name (add 20261018)
+ * 1: header
+ * 0: not header
+ */
+static int is_header_file(char *src)
+{
+    if (strrchr(src, '.'))
+        if (*(strrchr(src, '.') + 1) == 'h') return 1;
+    return 0;
+}
+
+/**
+ * gcov data memory free
+ */
+void dgc_free_gcov_data(GCOV_DATA *p)
+{
+    GCOV_DATA *p_next;
+
+    for(; p; p = p_next) {
+        gcov_line_free(&p->linebuf); /* 20261018 */
+        gcov_line_free(&p->joined);
+        free_gcov_line_data(p->line); /* 20110210 */
+        free_gcov_func_data(p->func); /* 20261018 */
+        p_next = p->next;
+        free(p);
+    }
+}
+
+/**
+ * gcov line data memory free
+ */
+static void free_gcov_line_data(GCOV_LINE_DATA *p)
+{
+    GCOV_LINE_DATA *p_next;
+
+    for(; p; p = p_next) {
+        free_gcov_branch_data(p->branch);
+        free_gcov_branch_data(p->cond); /* 20261018 */
+        free_gcov_inst_data(p->inst); /* 20261018 */
+        if (p->join) free_merge_cond(p->join->cond); /* 20261018 */
+        free(p->join);
+        p_next = p->next;
+        free(p);
+    }
+}
+
+/**
+ * gcov branch data memory free
+ */
+static void free_gcov_branch_data(GCOV_BRANCH_DATA *p)
+{
+    GCOV_BRANCH_DATA *p_next;
+
+    for(; p; p = p_next) {
+        p_next = p->next;
+        free(p);
+    }
+}
+
+/**
+ * gcov instance data memory free (add 20261018)
+ */
+static void free_gcov_inst_data(GCOV_INST_DATA *p)
+{
+    GCOV_INST_DATA *p_next;
+
+    for(; p; p = p_next) {
+        p_next = p->next;
+        free(p);
+    }
+}
+
+/**
+ * gcov function data memory free (add 20261018)
+ */
+static void free_gcov_func_data(GCOV_FUNC_DATA *p)
+{
+    GCOV_FUNC_DATA *p_next;
+
+    for(; p; p = p_next) {
+        p_next = p->next;
+        free(p);
+    }
+}
+
+/*************** calc (with diff merge gcov file) **************/
+
+/**
+ * get gcov line executed parcent
+ */
+void dgc_parcent(GCOV_DATA *p)
+{
+    char linebuf[LINEBUFSZ];
+    char *ptr;
+    GCOV_LINE_DATA *pl;
+    GCOV_BRANCH_DATA *pb;
+    GCOV_FUNC_DATA *pf;
+    int covered, total;
+
+    for(pf = p->func; pf; pf = pf->next) { /* 20261018 */
+        if (dgc_gcov_func_called(&p->linebuf, pf) > 0) p->func_pass++;
+        else p->func_notpass++;
+    }
+
+    for(pl = p->line; pl; pl = pl->next) {
+        memset(linebuf, 0, sizeof(linebuf));
+        if (dgc_gcov_line_get_by_pos(&p->linebuf, linebuf, sizeof(linebuf)-1, pl->s_pos, pl->e_pos) == 0) break; /* 20100531 */
+
+        if ((ptr = strchr(linebuf, ':')) == NULL) continue;
+        pl->count = parse_gcov_count(linebuf, &pl->exec); /* 20261018 */
+
+        ptr--;
+        if (*ptr == '*') ptr--; /* not all blocks executed (20261018) */
+        if (isdigit(*ptr)) p->line_pass++;
+        else if (*ptr == '#') p->line_notpass++;
+
+        /* -- add 20110210 */
+        for(pb = pl->branch; pb; pb = pb->next) {
+            memset(linebuf, 0, sizeof(linebuf));
+            if (dgc_gcov_line_get_by_pos(dgc_gcov_branch_buf(p, pb), linebuf, sizeof(linebuf)-1, pb->s_pos, pb->e_pos) == 0) break;
+            pb->taken = parse_branch_taken(linebuf); /* 20261018 */
+            if (strstr(linebuf, " 0%") || strstr(linebuf, "never")) {
+                pl->branch_notpass++;
+                p->branch_notpass++;
+            } else {
+                pl->branch_pass++;
+                p->branch_pass++;
+            }
+        }
+        /* -- add 20110210 */
+
+        for(pb = pl->cond; pb; pb = pb->next) { /* 20261018 */
+            memset(linebuf, 0, sizeof(linebuf));
+            if (dgc_gcov_line_get_by_pos(dgc_gcov_branch_buf(p, pb), linebuf, sizeof(linebuf)-1, pb->s_pos, pb->e_pos) == 0) break;
+            if (sscanf(linebuf, "condition outcomes covered %d/%d", &covered, &total) != 2) continue;
+            pl->cond_pass += covered;
+            pl->cond_total += total;
+            p->cond_pass += covered;
+            p->cond_notpass += total - covered;
+        }
+    }
+
+    if ((p->line_pass + p->line_notpass) != 0)
+        p->line_parcent = (double)p->line_pass / (p->line_pass + p->line_notpass) * 100;
+    if ((p->branch_pass + p->branch_notpass) != 0) { /* 20110210 */
+        p->branch_parcent = (double)p->branch_pass / (p->branch_pass + p->branch_notpass) * 100;
+    } else {
+        p->branch_parcent = 100.0;
+    }
+    p->func_parcent = (p->func_pass + p->func_notpass) ? (double)p->func_pass / (p->func_pass + p->func_notpass) * 100 : 100.0; /* 20261018 */
+    p->cond_parcent = (p->cond_pass + p->cond_notpass) ? (double)p->cond_pass / (p->cond_pass + p->cond_notpass) * 100 : 100.0;
+}
+
+/**
+ * stream one gcov data (add 20261018)
+ * report the result at once, then free the gcov text and line list.
+ * only the counters are kept for the summary, so memory does not grow
+ * with the size of changed files.
+ */
+static void stream_gcov(GCOV_STREAM *stream, GCOV_DATA *p)
+{
+    dgc_parcent(p);
+    stream->report(stream->arg, p);
+
+    gcov_line_free(&p->linebuf);
+    gcov_line_free(&p->joined); /* 20261018 */
+    free_gcov_line_data(p->line);
+    p->line = NULL;
+    p->unknown = NULL;
+
+    p->next = NULL;
+    if (stream->top == NULL) stream->top = p;
+    else stream->last->next = p;
+    stream->last = p;
+}
+
+/****** gcov record parse (add 20261018) ******/
+/**
+ * parse execution count of gcov line
+ * ex)        6:   10:  -> 6
+ *        1.2k*:   10:  -> 1200 (-H human readable, * unexecuted block)
+ *        #####:   10:  -> 0
+ *            -:   10:  -> 0, exec = 0
+ */
+static unsigned long long parse_gcov_count(char *line, int *exec)
+{
+    char *c;
+    double count;
+
+    *exec = 0;
+    for (c = line; *c == ' '; c++);
+    if (*c == '#' || *c == '=') { *exec = 1; return 0; }
+    if (!isdigit(*c)) return 0;
+
+    *exec = 1;
+    count = strtod(c, &c);
+    switch (*c) {
+    case 'k': count *= 1e3;  break;
+    case 'M': count *= 1e6;  break;
+    case 'G': count *= 1e9;  break;
+    case 'T': count *= 1e12; break;
+    case 'P': count *= 1e15; break;
+    }
+    return (unsigned long long)(count + 0.5);
+}
+
+/**
+ * parse branch taken percentage
+ * ex) branch  0 taken 83% (fallthrough) -> 83
+ *     branch  1 never executed         -> -1
+ */
+static int parse_branch_taken(char *line)
+{
+    char *c;
+
+    if ((c = strstr(line, "taken ")) == NULL) return -1;
+    return atoi(c + strlen("taken "));
+}
+
+/**
+ * parse function called count (add 20261018)
+ * ex) function f called 3 returned 100% blocks executed 88% -> 3
+ */
+static unsigned long long parse_func_called(char *line)
+{
+    char *c;
+
+    if ((c = strstr(line, " called ")) == NULL) return 0;
+    return strtoull(c + strlen(" called "), NULL, 10);
+}
+
+/**
+ * analyze diff format
+ * (add 20100531)
+ */
+int dgc_get_diff_format(char *filename)
+{
+    FILE *fp;
+    int diff_fmt;
+
+    if ((fp = fopen(filename, "r")) == NULL) return DGC_UNKNOWN_FMT;
+    diff_fmt = get_diff_format_fp(fp);
+    fclose(fp);
+    return diff_fmt;
+}
+
+/**
+ * analyze diff format of opened stream
+ * (split from get_diff_format 20261018)
+ */
+static int get_diff_format_fp(FILE *fp)
+{
+    char linebuf[LINEBUFSZ];
+    READ_BUF readbuf;
+    unsigned long svn, cvs, diffall, git, index;
+    int diff_fmt = DGC_UNKNOWN_FMT;
+
+    svn = cvs = diffall = git = index = 0;
+
+    memset(&readbuf, 0, sizeof(readbuf));
+
+    while(1) {
+        memset(linebuf, 0, sizeof(linebuf));
+        if (readline(linebuf, &readbuf, fp) == -1) break; /* eof */
+
+        if (linebuf[0] == '@' && linebuf[1] == '@') {
+            svn++;
+        }
+        if (strstr(linebuf, "RCS file")) {
+            cvs++;
+        }
+        if (strstr(linebuf, "Target=")) {
+            diffall++;
+        }
+        if (strncmp(linebuf, "diff --git ", 11) == 0) { /* 20261018 */
+            git++;
+        }
+        if (strncmp(linebuf, "Index:", 6) == 0) {
+            index++;
+        }
+    }
+
+    if (diffall > 0)   diff_fmt = DGC_DIFF_FMT;
+    if (cvs > diffall) diff_fmt = DGC_CVS_FMT;
+    if (svn > cvs)     diff_fmt = DGC_SVN_FMT;
+    if (git > 0 && index == 0 && cvs == 0) diff_fmt = DGC_GIT_FMT; /* 20261018 */
+    return diff_fmt;
+}
+
+/****** unified diff (svn, git) helpers ******/
+/**
+ * check svn diff summary line (add 20100531)
+ * 1: summary line
+ * 0: not summary line
+ */
+static int is_svndiff_summary(char *line)
+{
+    if (line[0] == '@' && line[1] == '@') return 1;
+    return 0;
+}
+
+/**
+ * check svn diff start section (add 20100531)
+ * 1: start
+ * 0: not start
+ *
+ * ex)
+ * | aaaaa....
+ * |-bbbbb....
+ * |+ccccc.... <- start line
+ * |+ddddd....
+ * | edddd....
+ */
+static int is_svndiff_start(READ_BUF *p)
+{
+    if (p->prev[0] != '+' && p->crnt[0] == '+') return 1;
+    return 0;
+}
+
+/**
+ * check svn diff end section (add 20100531)
+ * 1: end
+ * 0: not end
+ *
+ * ex)
+ * | aaaaa....
+ * |-bbbbb....
+ * |+ccccc....
+ * |+ddddd.... <- end line
+ * | edddd....
+ */
+static int is_svndiff_end(READ_BUF *p)
+{
+    if (p->crnt[0] == '+' && p->next[0] != '+') return 1;
+    return 0;
+}
+
+/**
+ * svn diff summary line analyze (add 20100531)
+ * 0: error
+ * >0: base line
+ *
+ * ex)
+ * @@ -130,7 +130,7 @@
+ *            ^^^
+ */
+static int get_svndiff_baseline(char *line)
+{
+    char *p1;
+
+    if ((p1 = strchr(line, '+')) == NULL) return 0;
+    p1++;
+    if (!isdigit(*p1)) return 0;
+    return atoi(p1); /* "+130,7" or "+130" (one line hunk 20261018) */
+}
+
+/******* GCOV_LINE_BUF accessor *******/
+/**
+ * GCOV_LINE create & data copy (add 20100531)
+ * 0: error
+ * >0: copied size
+ * s_pos : copy start buffer position (output param)
+ * e_pos : copy end buffer position (output param)
+ * (the buffer is doubled as needed, a mapped buffer is read only 20261018)
+ */
+static unsigned long long gcov_line_data_copy(GCOV_LINE_BUF *p, char *data, unsigned long long sz, unsigned long long *s_pos, unsigned long long *e_pos)
+{
+    char *tmp;
+    unsigned long long max;
+
+    if (p->mapped) return 0;
+    if (p->top == NULL) {
+        if ((p->top = (char *)malloc(LINEBUFSZ * 10)) == NULL) return 0;
+        p->max = LINEBUFSZ * 10;
+        p->pos = 0;
+    }
+
+    if ( (p->pos + sz) > (p->max - 1) ) {
+        for (max = p->max * 2; (p->pos + sz) > (max - 1); max *= 2);
+        if ((tmp = (char *)realloc(p->top, max)) == NULL) return 0;
+        p->top = tmp;
+        p->max = max;
+    }
+    *s_pos = p->pos;      /* 20110210 */
+    *e_pos = p->pos + sz; /* 20110210 */
+    memcpy(p->top + p->pos, data, sz);
+    p->pos += sz;
+    p->top[p->pos] = 0; /* null terminate */
+
+    return sz;
+}
+
+/**
+ * GCOV_LINE record copy to a new string (add 20261018)
+ * the line end is not copied.
+ * NULL: error
+ */
+static char *gcov_line_strdup(GCOV_LINE_BUF *p, unsigned long long s_pos, unsigned long long e_pos)
+{
+    char *line;
+
+    while (e_pos > s_pos && (p->top[e_pos-1] == '\n' || p->top[e_pos-1] == '\r')) e_pos--;
+    if ((line = (char *)malloc(e_pos - s_pos + 1)) == NULL) return NULL;
+    memcpy(line, p->top + s_pos, e_pos - s_pos);
+    line[e_pos - s_pos] = 0;
+    return line;
+}
+
+/**
+ * GCOV_LINE create & formatted data copy (add 20261018)
+ * 0: error
+ * >0: copied size
+ */
+static unsigned long long gcov_line_data_printf(GCOV_LINE_BUF *p, unsigned long long *s_pos, unsigned long long *e_pos, const char *fmt, ...)
+{
+    va_list ap;
+    char *data;
+    int sz;
+    unsigned long long ret;
+
+    va_start(ap, fmt);
+    sz = vsnprintf(NULL, 0, fmt, ap);
+    va_end(ap);
+    if (sz <= 0 || (data = (char *)malloc(sz + 1)) == NULL) return 0;
+    va_start(ap, fmt);
+    vsnprintf(data, sz + 1, fmt, ap);
+    va_end(ap);
+    ret = gcov_line_data_copy(p, data, sz, s_pos, e_pos);
+    free(data);
+    return ret;
+}
+
+/**
+ * GCOV_LINE map file (add 20261018)
+ * the file is referred in place. an empty file has no top.
+ * 0: ok
+ * -1: error
+ */
+static int gcov_line_map(GCOV_LINE_BUF *p, char *path)
+{
+    IO_REQ req;
+
+    memset(p, 0, sizeof(GCOV_LINE_BUF));
+    memset(&req, 0, sizeof(req));
+    if (strlen(path) >= sizeof(req.path)) return -1;
+    strcpy(req.path, path);
+    req.flags = IO_MAP;
+    req.fd = -1;
+    io_sync_req(&req);
+    if (req.err) return -1;
+    p->top = req.buf;
+    p->max = p->pos = req.sz;
+    p->mapped = 1;
+    return 0;
+}
+
+/**
+ * GCOV_LINE create from a copy of data (add 20261018)
+ * a resident buffer must not refer to the file mapping, as gcov
+ * truncates and rewrites the .gcov file (SIGBUS on the mapping).
+ * 0: ok
+ * -1: error
+ */
+static int gcov_line_dup(GCOV_LINE_BUF *p, char *data, unsigned long long sz)
+{
+    memset(p, 0, sizeof(GCOV_LINE_BUF));
+    if ((p->top = (char *)malloc(sz + 1)) == NULL) return -1;
+    if (sz) memcpy(p->top, data, sz);
+    p->top[sz] = 0;
+    p->max = sz + 1;
+    p->pos = sz;
+    return 0;
+}
+
+/**
+ * GCOV_LINE memory free (add 20261018)
+ */
+static void gcov_line_free(GCOV_LINE_BUF *p)
+{
+    if (p->top) {
+        if (p->mapped) munmap(p->top, p->max);
+        else free(p->top);
+    }
+    memset(p, 0, sizeof(GCOV_LINE_BUF));
+}
+
+/**
+ * GCOV_LINE next line position (add 20261018)
+ * the line at refpos is not copied, and has no length limit.
+ * 0: eof
+ * 1: ok (s_pos, e_pos: line position, \n is not included)
+ */
+static int gcov_line_next(GCOV_LINE_BUF *p, unsigned long long *s_pos, unsigned long long *e_pos)
+{
+    char *c;
+
+    if (p->top == NULL || p->refpos >= p->pos) return 0;
+    *s_pos = p->refpos;
+    if ((c = (char *)memchr(p->top + p->refpos, '\n', p->pos - p->refpos)) == NULL) {
+        *e_pos = p->pos;
+        p->refpos = p->pos;
+    } else {
+        *e_pos = c - p->top;
+        p->refpos = *e_pos + 1;
+    }
+    return 1;
+}
+
+/**
+ * GCOV_LINE source line number (add 20261018)
+ * ex)         6:   10:    y += i;  -> 10
+ * >=0: line number
+ * -1: no ':' (function, branch, call ...)
+ */
+static int gcov_line_lineno(GCOV_LINE_BUF *p, unsigned long long s_pos, unsigned long long e_pos)
+{
+    char *c, *end = p->top + e_pos;
+    int lineno = 0;
+
+    if ((c = (char *)memchr(p->top + s_pos, ':', e_pos - s_pos)) == NULL) return -1;
+    for (c++; c < end && *c == ' '; c++);
+    for (; c < end && isdigit(*c); c++) lineno = lineno * 10 + (*c - '0');
+    return lineno;
+}
+
+/**
+ * GCOV_LINE print with \n (add 20261018)
+ */
+void dgc_gcov_line_print(FILE *fp, GCOV_LINE_BUF *p, unsigned long long s_pos, unsigned long long e_pos)
+{
+    if (p->top == NULL) return;
+    fwrite(p->top + s_pos, 1, e_pos - s_pos, fp);
+    fputc('\n', fp);
+}
+
+/**
+ * GCOV_LINE get by position (add 20110210)
+ * 0: error
+ * >0: read size
+ * attention: \n is read
+ */
+int dgc_gcov_line_get_by_pos(GCOV_LINE_BUF *p, char *out, unsigned long outsz, unsigned long long s_pos, unsigned long long e_pos)
+{
+    int pos = 0;
+    unsigned long long refpos = s_pos;
+
+    if (p->top == NULL) return 0;
+
+    for (pos = 0; pos < outsz; ) {
+        if (refpos >= p->pos) break;
+        if (refpos == e_pos) break;
+
+        out[pos] = p->top[refpos];
+        pos++;
+        refpos++;
+    }
+    return pos;
+}
+
+/***** check gcov file timestamp *****/
+/**
+ * check gcov timestamp
+ * (stat of all .gcov/.gcda is issued at once by io_batch 20261018)
+ * mtime is compared in nanoseconds. stamp: a .gcda with the same
+ * content as at the last gcov_update() is up to date whatever its
+ * mtime is (restored cache, clock skew), the .gcda files are mapped
+ * in the same batch for it. (20261018)
+ * 0: no need
+ * 1: need update gcov file
+ */
+int dgc_need_gcov_update(DIFF_DATA *diff, int jobs, int stamp)
+{
+    char base[FILENAMESZ];
+    IO_BATCH batch;
+    IO_REQ *req, *gcov, *gcda;
+    DIFF_DATA *d;
+    STAMP_TABLE table;
+    GCDA_STAMP cur, *rec;
+    int i, n;
+    int need_update = 0;
+
+    memset(&table, 0, sizeof(table));
+    if (stamp) load_gcda_stamp((char *)STAMP_FILENAME, &table); /* 20261018 */
+
+    for (n = 0, d = diff; d; d = d->next) n++;
+    if ((req = (IO_REQ *)calloc(n * 2, sizeof(IO_REQ))) == NULL) { free_gcda_stamp(&table); return 0; }
+
+    for (n = 0; diff; diff = diff->next) {
+        if (strlen(diff->src) == 0) continue;
+        if (is_header_file(diff->src)) continue; /* header file */
+
+        memset(base, 0, sizeof(base));
+        strncpy(base, diff->src, sizeof(base)-1);
+        if (strrchr(base, '.')) *strrchr(base, '.') = 0;
+        snprintf(req[n].path, sizeof(req[n].path), "./%s.gcov", diff->src);
+        snprintf(req[n+1].path, sizeof(req[n+1].path), "./%s.gcda", base);
+        req[n].flags = IO_STAT;
+        req[n+1].flags = table.n > 0 ? IO_MAP : IO_STAT; /* 20261018 */
+        n += 2;
+    }
+    io_batch_submit(&batch, req, n, jobs);
+
+    for (i = 0; i < n; i += 2) {
+        gcov = &req[i];
+        gcda = &req[i+1];
+        io_batch_wait(&batch, i+1);
+        io_batch_wait(&batch, i);
+        rec = NULL;
+        if (table.n > 0 && gcda->err == 0) { /* 20261018 */
+            set_gcda_stamp(&cur, gcda);
+            rec = find_gcda_stamp(&table, gcda->path);
+        }
+        io_batch_release(&batch, i);
+        io_batch_release(&batch, i+1);
+        if (gcda->err) continue;
+        if (gcov->err) {
+            printf("!!! %s is none !!!\n", gcov->path);
+            need_update = 1;
+            continue;
+        }
+
+        if (rec && rec->size == cur.size && rec->stamp == cur.stamp && rec->hash == cur.hash) continue; /* 20261018 */
+        if (gcov->mtime_sec < gcda->mtime_sec
+            || (gcov->mtime_sec == gcda->mtime_sec && gcov->mtime_nsec < gcda->mtime_nsec)) { /* 20261018 */
+            printf("!!! %s needs update !!!\n", gcov->path);
+            need_update = 1;
+        }
+    }
+
+    io_batch_finish(&batch);
+    free(req);
+    free_gcda_stamp(&table);
+    return need_update;
+}
+
+/**
+ * load gcda stamp file (no file: empty table) (add 20261018)
+ * format)
+ *  DIFFGCOV-STAMP 1
+ *  stamp size hash gcda  <- gcc checksum stamp and FNV-1a hash in hex
+ * 0: ok
+ * -1: error
+ */
+static int load_gcda_stamp(char *file, STAMP_TABLE *t)
+{
+    FILE *fp;
+    char linebuf[LINEBUFSZ];
+    READ_BUF readbuf;
+    GCDA_STAMP s, *tmp;
+    int pos;
+
+    memset(t, 0, sizeof(STAMP_TABLE));
+    if ((fp = fopen(file, "r")) == NULL) return 0;
+
+    memset(&readbuf, 0, sizeof(readbuf));
+    memset(linebuf, 0, sizeof(linebuf));
+    if (readline(linebuf, &readbuf, fp) == -1 || strcmp(linebuf, STAMP_MAGIC) != 0) {
+        printf("!!! %s is not gcda stamp !!!\n", file);
+        fclose(fp);
+        return -1;
+    }
+
+    while(1) {
+        memset(linebuf, 0, sizeof(linebuf));
+        if (readline(linebuf, &readbuf, fp) == -1) break; /* eof */
+
+        memset(&s, 0, sizeof(s));
+        if (sscanf(linebuf, "%x %llu %llx %n", &s.stamp, &s.size, &s.hash, &pos) != 3) continue;
+        if (strlen(linebuf + pos) == 0 || strlen(linebuf + pos) >= sizeof(s.gcda)) continue;
+        strcpy(s.gcda, linebuf + pos);
+        if (t->n == t->max) {
+            if ((tmp = (GCDA_STAMP *)realloc(t->stamp, (t->max ? t->max * 2 : 256) * sizeof(GCDA_STAMP))) == NULL) break;
+            t->stamp = tmp;
+            t->max = t->max ? t->max * 2 : 256;
+        }
+        t->stamp[t->n++] = s;
+    }
+    fclose(fp);
+    qsort(t->stamp, t->n, sizeof(GCDA_STAMP), compare_gcda_stamp);
+    return 0;
+}
+
+/**
+ * save stamps of all .gcda files under current directory (add 20261018)
+ * the paths are "./" + relative path, the same as dgc_need_gcov_update()
+ * looks up for the source of diff. ex) "./src/foo.gcda"
+ * the files are mapped at once by io_batch and hashed.
+ * 0: ok
+ * -1: error
+ */
+int dgc_save_gcda_stamp_dir(char *file, int jobs)
+{
+    IO_BATCH batch;
+    IO_REQ *req;
+    GCDA_STAMP s;
+    FILE *fp;
+    char **names = NULL;
+    int i, n = 0, max = 0;
+
+    if (list_dir_files((char *)".", "", ".gcda", &names, &n, &max) != 0
+        || (req = (IO_REQ *)calloc(n ? n : 1, sizeof(IO_REQ))) == NULL) {
+        for (i = 0; i < n; i++) free(names[i]);
+        free(names);
+        return -1;
+    }
+    for (i = 0; i < n; i++) {
+        snprintf(req[i].path, sizeof(req[i].path), "./%s", names[i]);
+        req[i].flags = IO_MAP;
+        free(names[i]);
+    }
+    free(names);
+
+    if ((fp = fopen(file, "w")) == NULL) { free(req); return -1; }
+    fprintf(fp, "%s\n", STAMP_MAGIC);
+    io_batch_submit(&batch, req, n, jobs);
+    for (i = 0; i < n; i++) {
+        io_batch_wait(&batch, i);
+        if (req[i].err == 0) {
+            set_gcda_stamp(&s, &req[i]);
+            fprintf(fp, "%x %llu %llx %s\n", s.stamp, s.size, s.hash, req[i].path);
+        }
+        io_batch_release(&batch, i);
+    }
+    io_batch_finish(&batch);
+    free(req);
+    return fclose(fp) == 0 ? 0 : -1;
+}
+
+/**
+ * get stamp of mapped .gcda (add 20261018)
+ * ex) gcda header: magic "adcg", version, stamp (4 bytes each)
+ */
+static void set_gcda_stamp(GCDA_STAMP *s, IO_REQ *r)
+{
+    memset(s, 0, sizeof(GCDA_STAMP));
+    strcpy(s->gcda, r->path);
+    s->size = r->sz;
+    if (r->sz >= 12) memcpy(&s->stamp, r->buf + 8, sizeof(s->stamp));
+    s->hash = hash_data(r->buf, r->sz);
+}
+
+/**
+ * find stamp of .gcda (sorted table)
+ * NULL: not found
+ */
+static GCDA_STAMP *find_gcda_stamp(STAMP_TABLE *t, char *gcda)
+{
+    GCDA_STAMP key;
+
+    if (t->n == 0 || strlen(gcda) >= sizeof(key.gcda)) return NULL;
+    strcpy(key.gcda, gcda);
+    return (GCDA_STAMP *)bsearch(&key, t->stamp, t->n, sizeof(GCDA_STAMP), compare_gcda_stamp);
+}
+
+/**
+ * qsort compare (gcda stamp by name)
+ */
+static int compare_gcda_stamp(const void *a, const void *b)
+{
+    return strcmp(((const GCDA_STAMP *)a)->gcda, ((const GCDA_STAMP *)b)->gcda);
+}
+
+/**
+ * hash of data (FNV-1a 64bit) (add 20261018)
+ */
+static unsigned long long hash_data(char *data, unsigned long long sz)
+{
+    unsigned long long h = 14695981039346656037ULL;
+    unsigned long long i;
+
+    for (i = 0; i < sz; i++) {
+        h ^= (unsigned char)data[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/**
+ * gcda stamp table memory free
+ */
+static void free_gcda_stamp(STAMP_TABLE *t)
+{
+    free(t->stamp);
+    memset(t, 0, sizeof(STAMP_TABLE));
+}
+
+/******* batched file I/O (add 20261018) *******/
+/**
+ * start open/stat/map of all requests
+ * io_uring is used when the kernel supports it, otherwise a thread pool.
+ * 0: ok
+ * -1: error (requests are done synchronously)
+ */
+static int io_batch_submit(IO_BATCH *b, IO_REQ *req, int nreq, int jobs)
+{
+    int i;
+
+    memset(b, 0, sizeof(IO_BATCH));
+    b->req = req;
+    b->nreq = nreq;
+    for (i = 0; i < nreq; i++) req[i].fd = -1;
+    if (nreq == 0) return 0;
+    b->window = jobs * 2; /* the parser takes one, and the next ones are read ahead */
+    if (b->window < 2) b->window = 2;
+    if (b->window > IO_WINDOW_MAX) b->window = IO_WINDOW_MAX;
+
+    if (io_uring_init(&b->ring, IO_URING_ENTRIES) == 0) {
+        b->backend = IO_URING;
+        while (b->next < nreq && b->active < b->window) io_uring_start_req(b, b->next++);
+        io_uring_submit_wait(&b->ring, 0);
+        return 0;
+    }
+
+    pthread_mutex_init(&b->mutex, NULL);
+    pthread_cond_init(&b->cond, NULL);
+    b->nthread = jobs < nreq ? jobs : nreq;
+    if (b->nthread < 1) b->nthread = 1;
+    if ((b->th = (pthread_t *)calloc(b->nthread, sizeof(pthread_t))) != NULL) {
+        for (i = 0; i < b->nthread; i++) {
+            if (pthread_create(&b->th[i], NULL, io_thread_worker, b) != 0) break;
+        }
+        b->nthread = i;
+    }
+    b->backend = IO_THREAD;
+    if (b->nthread > 0) return 0;
+
+    /* no thread: done in io_batch_wait() */
+    free(b->th);
+    pthread_mutex_destroy(&b->mutex);
+    pthread_cond_destroy(&b->cond);
+    b->backend = IO_NONE;
+    return -1;
+}
+
+/**
+ * wait for request i
+ * 0: ok
+ * -1: error (req->err)
+ */
+static int io_batch_wait(IO_BATCH *b, int i)
+{
+    IO_REQ *r = &b->req[i];
+
+    while (b->backend == IO_URING && !r->done) {
+        if (io_uring_reap(b, 1) < 0) io_uring_abort(b); /* ring broken: the rest is done synchronously */
+    }
+    if (b->backend == IO_THREAD) {
+        pthread_mutex_lock(&b->mutex);
+        while (!r->done) pthread_cond_wait(&b->cond, &b->mutex);
+        pthread_mutex_unlock(&b->mutex);
+    } else if (b->backend == IO_NONE && !r->done) {
+        io_sync_req(r);
+        r->done = 1;
+    }
+    return r->err ? -1 : 0;
+}
+
+/**
+ * release request i (its mapping is unmapped, if not taken)
+ * at most b->window (2 x jobs, up to IO_WINDOW_MAX) requests are started
+ * and not released, so that open files and mappings stay bounded by
+ * b->window x the largest file. requests must be released in order.
+ */
+static void io_batch_release(IO_BATCH *b, int i)
+{
+    IO_REQ *r = &b->req[i];
+
+    if (r->released) return;
+    r->released = 1;
+    if (r->buf) munmap(r->buf, r->sz);
+    r->buf = NULL;
+
+    if (b->backend == IO_URING) {
+        b->released++;
+        b->active--;
+        while (b->next < b->nreq && b->active < b->window) io_uring_start_req(b, b->next++);
+        if (b->ring.to_submit > 0) io_uring_submit_wait(&b->ring, 0);
+    } else if (b->backend == IO_THREAD) {
+        pthread_mutex_lock(&b->mutex);
+        b->released++;
+        pthread_cond_broadcast(&b->cond);
+        pthread_mutex_unlock(&b->mutex);
+    }
+}
+
+/**
+ * wait all requests, and release batch resources
+ * (unconsumed mappings are unmapped)
+ */
+static void io_batch_finish(IO_BATCH *b)
+{
+    int i;
+
+    for (i = 0; i < b->nreq; i++) {
+        io_batch_wait(b, i);
+        io_batch_release(b, i);
+    }
+    if (b->backend == IO_URING) {
+        io_uring_exit(&b->ring);
+    } else if (b->backend == IO_THREAD) {
+        for (i = 0; i < b->nthread; i++) pthread_join(b->th[i], NULL);
+        free(b->th);
+        pthread_mutex_destroy(&b->mutex);
+        pthread_cond_destroy(&b->cond);
+    }
+    b->backend = IO_NONE;
+}
+
+/**
+ * do one request synchronously (thread pool, fallback)
+ */
+static void io_sync_req(IO_REQ *r)
+{
+    struct stat st;
+
+    if (!(r->flags & IO_MAP)) {
+        if (stat(r->path, &st) < 0) { r->err = errno; return; }
+    } else {
+        if ((r->fd = open(r->path, O_RDONLY)) < 0) { r->err = errno; return; }
+        if (fstat(r->fd, &st) < 0) { r->err = errno; close(r->fd); r->fd = -1; return; }
+    }
+    r->size = st.st_size;
+    r->mtime_sec = st.st_mtim.tv_sec;
+    r->mtime_nsec = st.st_mtim.tv_nsec;
+    if (!(r->flags & IO_MAP)) return;
+
+    io_map_fd(r);
+    close(r->fd);
+    r->fd = -1;
+}
+
+/**
+ * map opened file of request (add 20261018)
+ * the file is read by page faults, not copied. an empty file is not
+ * mapped (buf NULL, sz 0). MADV_WILLNEED starts the readahead when the
+ * request completes, so the parser thread seldom blocks on the faults.
+ */
+static void io_map_fd(IO_REQ *r)
+{
+    void *map;
+
+    if (r->size == 0) return;
+    if ((map = mmap(NULL, r->size, PROT_READ, MAP_PRIVATE, r->fd, 0)) == MAP_FAILED) {
+        r->err = errno;
+        return;
+    }
+    madvise(map, r->size, MADV_SEQUENTIAL);
+    madvise(map, r->size, MADV_WILLNEED); /* start readahead now, not at first fault (20261018) */
+    r->buf = (char *)map;
+    r->sz = r->size;
+}
+
+/**
+ * thread pool worker
+ */
+static void *io_thread_worker(void *arg)
+{
+    IO_BATCH *b = (IO_BATCH *)arg;
+    int i;
+
+    while (1) {
+        pthread_mutex_lock(&b->mutex);
+        while (b->next < b->nreq && b->next - b->released >= b->window) pthread_cond_wait(&b->cond, &b->mutex);
+        i = b->next++;
+        pthread_mutex_unlock(&b->mutex);
+        if (i >= b->nreq) break;
+
+        io_sync_req(&b->req[i]);
+        pthread_mutex_lock(&b->mutex);
+        b->req[i].done = 1;
+        pthread_cond_broadcast(&b->cond);
+        pthread_mutex_unlock(&b->mutex);
+    }
+    return NULL;
+}
+
+/**
+ * io_uring setup (raw syscall, no liburing)
+ * 0: ok
+ * -1: io_uring or needed opcode is not available
+ */
+static int io_uring_init(IO_URING_CTX *ctx, unsigned entries)
+{
+    struct io_uring_params params;
+    struct io_uring_probe *probe;
+    size_t probe_sz;
+    int ok;
+
+    memset(ctx, 0, sizeof(IO_URING_CTX));
+    memset(&params, 0, sizeof(params));
+    if ((ctx->fd = syscall(__NR_io_uring_setup, entries, &params)) < 0) return -1;
+
+    /* OPENAT, STATX are needed (linux 5.6) */
+    probe_sz = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    ok = 0;
+    if ((probe = (struct io_uring_probe *)calloc(1, probe_sz)) != NULL) {
+        if (syscall(__NR_io_uring_register, ctx->fd, IORING_REGISTER_PROBE, probe, 256) == 0) {
+            ok = probe->last_op >= IORING_OP_STATX
+                && (probe->ops[IORING_OP_OPENAT].flags & IO_URING_OP_SUPPORTED)
+                && (probe->ops[IORING_OP_STATX].flags & IO_URING_OP_SUPPORTED);
+        }
+        free(probe);
+    }
+    if (!ok) { close(ctx->fd); return -1; }
+
+    ctx->entries = params.sq_entries;
+    ctx->sq_sz = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ctx->cq_sz = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (ctx->cq_sz > ctx->sq_sz) ctx->sq_sz = ctx->cq_sz;
+        ctx->cq_sz = ctx->sq_sz;
+    }
+    ctx->sq_ptr = mmap(NULL, ctx->sq_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ctx->fd, IORING_OFF_SQ_RING);
+    if (ctx->sq_ptr == MAP_FAILED) { close(ctx->fd); return -1; }
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        ctx->cq_ptr = ctx->sq_ptr;
+    } else {
+        ctx->cq_ptr = mmap(NULL, ctx->cq_sz, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ctx->fd, IORING_OFF_CQ_RING);
+        if (ctx->cq_ptr == MAP_FAILED) {
+            munmap(ctx->sq_ptr, ctx->sq_sz);
+            close(ctx->fd);
+            return -1;
+        }
+    }
+    ctx->sqes = (struct io_uring_sqe *)mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe),
+        PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ctx->fd, IORING_OFF_SQES);
+    if (ctx->sqes == MAP_FAILED) {
+        if (ctx->cq_ptr != ctx->sq_ptr) munmap(ctx->cq_ptr, ctx->cq_sz);
+        munmap(ctx->sq_ptr, ctx->sq_sz);
+        close(ctx->fd);
+        return -1;
+    }
+
+    ctx->sq_head  = (unsigned *)((char *)ctx->sq_ptr + params.sq_off.head);
+    ctx->sq_tail  = (unsigned *)((char *)ctx->sq_ptr + params.sq_off.tail);
+    ctx->sq_mask  = (unsigned *)((char *)ctx->sq_ptr + params.sq_off.ring_mask);
+    ctx->sq_array = (unsigned *)((char *)ctx->sq_ptr + params.sq_off.array);
+    ctx->cq_head  = (unsigned *)((char *)ctx->cq_ptr + params.cq_off.head);
+    ctx->cq_tail  = (unsigned *)((char *)ctx->cq_ptr + params.cq_off.tail);
+    ctx->cq_mask  = (unsigned *)((char *)ctx->cq_ptr + params.cq_off.ring_mask);
+    ctx->cqes = (struct io_uring_cqe *)((char *)ctx->cq_ptr + params.cq_off.cqes);
+    ctx->sq_local_tail = *ctx->sq_tail;
+    return 0;
+}
+
+/**
+ * io_uring release
+ */
+static void io_uring_exit(IO_URING_CTX *ctx)
+{
+    munmap(ctx->sqes, ctx->entries * sizeof(struct io_uring_sqe));
+    if (ctx->cq_ptr != ctx->sq_ptr) munmap(ctx->cq_ptr, ctx->cq_sz);
+    munmap(ctx->sq_ptr, ctx->sq_sz);
+    close(ctx->fd);
+}
+
+/**
+ * get free submission entry
+ * NULL: ring is full
+ */
+static struct io_uring_sqe *io_uring_get_sqe(IO_URING_CTX *ctx)
+{
+    unsigned head, idx;
+    struct io_uring_sqe *sqe;
+
+    head = __atomic_load_n(ctx->sq_head, __ATOMIC_ACQUIRE);
+    if (ctx->sq_local_tail - head >= ctx->entries) return NULL;
+
+    idx = ctx->sq_local_tail & *ctx->sq_mask;
+    sqe = &ctx->sqes[idx];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    ctx->sq_array[idx] = idx;
+    ctx->sq_local_tail++;
+    ctx->to_submit++;
+    return sqe;
+}
+
+/**
+ * submit queued entries, and wait for wait_nr completions
+ * >=0: submitted count
+ * -1: error
+ */
+static int io_uring_submit_wait(IO_URING_CTX *ctx, unsigned wait_nr)
+{
+    int ret;
+
+    __atomic_store_n(ctx->sq_tail, ctx->sq_local_tail, __ATOMIC_RELEASE);
+    do {
+        ret = syscall(__NR_io_uring_enter, ctx->fd, ctx->to_submit, wait_nr,
+                      wait_nr ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+    } while (ret < 0 && errno == EINTR);
+    if (ret < 0) return -1;
+    ctx->to_submit -= ret;
+    return ret;
+}
+
+/**
+ * queue first ops of request i (open+statx, or statx only)
+ * 0: ok
+ * -1: ring is full (request is done synchronously)
+ */
+static int io_uring_start_req(IO_BATCH *b, int i)
+{
+    IO_REQ *r = &b->req[i];
+    struct io_uring_sqe *sqe;
+    unsigned need = (r->flags & IO_MAP) ? 2 : 1;
+
+    b->active++; /* released by io_batch_release() in both ways */
+    if (b->ring.sq_local_tail - __atomic_load_n(b->ring.sq_head, __ATOMIC_ACQUIRE) + need > b->ring.entries) {
+        io_sync_req(r);
+        r->done = 1;
+        return -1;
+    }
+    if (r->flags & IO_MAP) {
+        sqe = io_uring_get_sqe(&b->ring);
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = (unsigned long)r->path;
+        sqe->open_flags = O_RDONLY;
+        sqe->user_data = ((unsigned long long)i << 2) | IO_OP_OPEN;
+        r->pending++;
+        r->queued |= 1 << IO_OP_OPEN; /* 20261018 */
+    }
+    sqe = io_uring_get_sqe(&b->ring);
+    sqe->opcode = IORING_OP_STATX;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (unsigned long)r->path;
+    sqe->len = STATX_SIZE | STATX_MTIME;
+    sqe->off = (unsigned long)&r->stx;
+    sqe->user_data = ((unsigned long long)i << 2) | IO_OP_STATX;
+    r->pending++;
+    r->queued |= 1 << IO_OP_STATX; /* 20261018 */
+    return 0;
+}
+
+/**
+ * reap completions (and refill the window)
+ * >=0: reaped count
+ * -1: error
+ */
+static int io_uring_reap(IO_BATCH *b, int wait)
+{
+    IO_URING_CTX *ctx = &b->ring;
+    struct io_uring_cqe *cqe;
+    unsigned head, tail;
+    int n = 0;
+
+    head = *ctx->cq_head;
+    tail = __atomic_load_n(ctx->cq_tail, __ATOMIC_ACQUIRE);
+    if (head == tail && wait) {
+        if (io_uring_submit_wait(ctx, 1) < 0) return -1;
+        tail = __atomic_load_n(ctx->cq_tail, __ATOMIC_ACQUIRE);
+    }
+    for (; head != tail; head++, n++) {
+        cqe = &ctx->cqes[head & *ctx->cq_mask];
+        io_uring_complete(b, (int)(cqe->user_data >> 2), (int)(cqe->user_data & 3), cqe->res);
+    }
+    __atomic_store_n(ctx->cq_head, head, __ATOMIC_RELEASE);
+
+    while (b->next < b->nreq && b->active < b->window) io_uring_start_req(b, b->next++);
+    if (ctx->to_submit > 0 && io_uring_submit_wait(ctx, 0) < 0) return -1;
+    return n;
+}
+
+/**
+ * one completion of request i
+ * the request is done when all its queued ops are completed. if an op
+ * was never taken by the kernel (partial submit, then ring broken), the
+ * others may complete alone (e.g. OPENAT without STATX gives size 0), so
+ * the request is left not done.
+ */
+static void io_uring_complete(IO_BATCH *b, int i, int op, int res)
+{
+    IO_REQ *r = &b->req[i];
+
+    r->pending--;
+    r->completed |= 1 << op; /* 20261018 */
+    if (op == IO_OP_OPEN) {
+        if (res < 0) r->err = -res;
+        else r->fd = res;
+    } else if (op == IO_OP_STATX) {
+        if (res < 0) {
+            r->err = -res;
+        } else {
+            r->size = r->stx.stx_size;
+            r->mtime_sec = r->stx.stx_mtime.tv_sec;
+            r->mtime_nsec = r->stx.stx_mtime.tv_nsec;
+        }
+    }
+    if (r->pending > 0) return;
+    if (r->completed != r->queued) return; /* an op was dropped: redone by io_uring_abort() (20261018) */
+
+    if (r->err == 0 && (r->flags & IO_MAP)) io_map_fd(r); /* 20261018 */
+    io_uring_finish_req(b, r);
+}
+
+/**
+ * request i is done
+ */
+static void io_uring_finish_req(IO_BATCH *b, IO_REQ *r)
+{
+    if (r->fd >= 0) close(r->fd);
+    r->fd = -1;
+    r->done = 1;
+}
+
+/**
+ * ring is broken: wait for the ops in flight, and close the ring
+ * the kernel writes statx results and fds to the requests, so they
+ * must be drained before the requests are freed. the requests not
+ * done (including those whose ops did not all complete) are done
+ * synchronously by io_batch_wait() (IO_NONE).
+ */
+static void io_uring_abort(IO_BATCH *b)
+{
+    IO_URING_CTX *ctx = &b->ring;
+    struct io_uring_cqe *cqe;
+    IO_REQ *r;
+    unsigned head, tail, t;
+    int i, pending;
+
+    /* queued entries not taken by the kernel never complete */
+    for (t = ctx->sq_local_tail - ctx->to_submit; t != ctx->sq_local_tail; t++) {
+        b->req[ctx->sqes[ctx->sq_array[t & *ctx->sq_mask]].user_data >> 2].pending--;
+    }
+    ctx->to_submit = 0;
+
+    while (1) {
+        for (pending = i = 0; i < b->next; i++) pending += b->req[i].pending;
+        if (pending == 0) break;
+        head = *ctx->cq_head;
+        tail = __atomic_load_n(ctx->cq_tail, __ATOMIC_ACQUIRE);
+        if (head == tail) {
+            usleep(1000);
+            continue;
+        }
+        for (; head != tail; head++) {
+            cqe = &ctx->cqes[head & *ctx->cq_mask];
+            io_uring_complete(b, (int)(cqe->user_data >> 2), (int)(cqe->user_data & 3), cqe->res);
+        }
+        __atomic_store_n(ctx->cq_head, head, __ATOMIC_RELEASE);
+    }
+    io_uring_exit(ctx);
+
+    for (i = 0; i < b->next; i++) {
+        r = &b->req[i];
+        if (r->done && r->completed == r->queued) continue;
+        if (r->buf) munmap(r->buf, r->sz); /* 20261018 */
+        r->buf = NULL;
+        r->sz = 0;
+        if (r->fd >= 0) close(r->fd);
+        r->fd = -1;
+        r->err = 0;
+        r->done = 0;
+    }
+    b->backend = IO_NONE;
+}
+
+/******* test impact index (add 20261018) *******/
+/**
+ * load test index file (no file: empty index)
+ * format)
+ *  DIFFGCOV-INDEX 1
+ *  T test_name           <- test id 0, 1, ...
+ *  S source
+ *  start end bitmap      <- executable lines, bitmap of test id in hex
+ *                           words (low word first, ',' separated)
+ *                           (0: executed by no test)
+ * 0: ok
+ * -1: error
+ */
+int dgc_load_test_index(char *file, TEST_INDEX *idx)
+{
+    FILE *fp;
+    char linebuf[LINEBUFSZ];
+    READ_BUF readbuf;
+    INDEX_SRC *s = NULL;
+    INDEX_RANGE *r, *r_prev;
+    unsigned long *tests;
+    char *c;
+    int i, start, end;
+
+    memset(idx, 0, sizeof(TEST_INDEX));
+    if ((fp = fopen(file, "r")) == NULL) return 0;
+
+    memset(&readbuf, 0, sizeof(readbuf));
+    memset(linebuf, 0, sizeof(linebuf));
+    if (readline(linebuf, &readbuf, fp) == -1 || strcmp(linebuf, INDEX_MAGIC) != 0) {
+        printf("!!! %s is not test index !!!\n", file);
+        fclose(fp);
+        return -1;
+    }
+
+    while(1) {
+        memset(linebuf, 0, sizeof(linebuf));
+        if (readline(linebuf, &readbuf, fp) == -1) break; /* eof */
+
+        if (linebuf[0] == 'T' && linebuf[1] == ' ') {
+            if (get_test_id(idx, linebuf + 2) < 0) break;
+        } else if (linebuf[0] == 'S' && linebuf[1] == ' ') {
+            if ((s = dgc_get_index_src(idx, linebuf + 2, 1)) == NULL) break;
+            r_prev = NULL;
+        } else if (isdigit(linebuf[0]) && s != NULL) {
+            start = strtol(linebuf, &c, 10);
+            end = strtol(c, &c, 10);
+            if ((tests = (unsigned long *)calloc(idx->nword, sizeof(unsigned long))) == NULL) break;
+            for (i = 0; i < idx->nword && *c; i++) {
+                tests[i] = strtoul(c, &c, 16);
+                if (*c == ',') c++;
+            }
+            r = new_index_range(idx, start, end, tests);
+            free(tests);
+            if (r == NULL) break;
+            if (r_prev == NULL) s->range = r;
+            else r_prev->next = r;
+            r_prev = r;
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+/**
+ * save test index file
+ * 0: ok
+ * -1: error
+ */
+int dgc_save_test_index(char *file, TEST_INDEX *idx)
+{
+    FILE *fp;
+    INDEX_SRC *s;
+    INDEX_RANGE *r;
+    int i;
+
+    if ((fp = fopen(file, "w")) == NULL) return -1;
+    fprintf(fp, "%s\n", INDEX_MAGIC);
+    for (i = 0; i < idx->ntest; i++) fprintf(fp, "T %s\n", idx->test[i]);
+    for (s = idx->src; s; s = s->next) {
+        fprintf(fp, "S %s\n", s->src);
+        for (r = s->range; r; r = r->next) {
+            fprintf(fp, "%d %d ", r->start, r->end);
+            for (i = 0; i < idx->nword; i++) fprintf(fp, i ? ",%lx" : "%lx", r->tests[i]);
+            fprintf(fp, "\n");
+        }
+    }
+    return fclose(fp) == 0 ? 0 : -1;
+}
+
+/**
+ * test index memory free
+ */
+void dgc_free_test_index(TEST_INDEX *idx)
+{
+    INDEX_SRC *s, *s_next;
+    INDEX_RANGE *r, *r_next;
+
+    for (s = idx->src; s; s = s_next) {
+        for (r = s->range; r; r = r_next) {
+            r_next = r->next;
+            free(r->tests);
+            free(r);
+        }
+        s_next = s->next;
+        free(s);
+    }
+    free(idx->test);
+    memset(idx, 0, sizeof(TEST_INDEX));
+}
+
+/**
+ * add executed lines of the .gcov files under dir to index as test
+ * (lines of the test already in index are replaced)
+ * the source is the path of .gcov from dir (ex: "src/foo.c.gcov" ->
+ * "src/foo.c"), as the diff names it. (subdirectories 20261018)
+ * the executable lines are added without test, so that the changed
+ * lines executed by no test can be counted.
+ * 0: ok
+ * -1: error
+ */
+int dgc_add_test_index(TEST_INDEX *idx, char *test, char *dir)
+{
+    char path[FILENAMESZ * 2];
+    char src[FILENAMESZ];
+    char **names = NULL;
+    INDEX_SRC *s;
+    INDEX_RANGE *r;
+    int *lines;
+    int id, i, n, max = 0, nname = 0, len, ret = 0;
+
+    if ((id = get_test_id(idx, test)) < 0) return -1;
+    for (s = idx->src; s; s = s->next) {
+        for (r = s->range; r; r = r->next) r->tests[id / 64] &= ~(1UL << (id % 64));
+    }
+
+    if (list_dir_files(dir, "", ".gcov", &names, &nname, &max) != 0) ret = -1; /* 20261018 */
+    for (i = 0; ret == 0 && i < nname; i++) {
+        len = strlen(names[i]);
+        memset(src, 0, sizeof(src));
+        memcpy(src, names[i], len - 5);
+        snprintf(path, sizeof(path), "%s/%s", dir, names[i]);
+        if ((n = read_gcov_executed(path, &lines, 1)) < 0) continue;
+        if ((s = dgc_get_index_src(idx, src, 1)) == NULL) ret = -1; /* in index even with no executable line */
+        if (ret == 0) ret = add_index_lines(idx, s, lines, n, -1);
+        free(lines);
+
+        if (ret != 0 || (n = read_gcov_executed(path, &lines, 0)) < 0) continue;
+        ret = add_index_lines(idx, s, lines, n, id);
+        free(lines);
+    }
+    for (i = 0; i < nname; i++) free(names[i]);
+    free(names);
+    for (s = idx->src; s; s = s->next) join_index_range(idx, s); /* once per source (20261018) */
+    return ret;
+}
+
+/**
+ * get test id (added when not found)
+ * >=0: test id
+ * -1: error
+ */
+static int get_test_id(TEST_INDEX *idx, char *test)
+{
+    char (*tmp)[FILENAMESZ];
+    unsigned long *tests;
+    INDEX_SRC *s;
+    INDEX_RANGE *r;
+    int i, nword;
+
+    for (i = 0; i < idx->ntest; i++) {
+        if (strcmp(idx->test[i], test) == 0) return i;
+    }
+
+    if ((tmp = (char (*)[FILENAMESZ])realloc(idx->test, (idx->ntest + 1) * FILENAMESZ)) == NULL) return -1;
+    idx->test = tmp;
+    memset(idx->test[idx->ntest], 0, FILENAMESZ);
+    strncpy(idx->test[idx->ntest], test, FILENAMESZ - 1);
+
+    /* bitmap grows by one word */
+    nword = idx->ntest / 64 + 1;
+    if (nword > idx->nword) {
+        for (s = idx->src; s; s = s->next) {
+            for (r = s->range; r; r = r->next) {
+                if ((tests = (unsigned long *)realloc(r->tests, nword * sizeof(unsigned long))) == NULL) return -1;
+                tests[nword - 1] = 0;
+                r->tests = tests;
+            }
+        }
+        idx->nword = nword;
+    }
+    return idx->ntest++;
+}
+
+/**
+ * get index source
+ * create: 1 add when not found
+ */
+INDEX_SRC *dgc_get_index_src(TEST_INDEX *idx, char *src, int create)
+{
+    INDEX_SRC *s, *s_prev = NULL;
+
+    for (s = idx->src; s; s = s->next) {
+        if (strcmp(s->src, src) == 0) return s;
+        s_prev = s;
+    }
+    if (!create) return NULL;
+
+    if ((s = (INDEX_SRC *)malloc(sizeof(INDEX_SRC))) == NULL) return NULL;
+    memset(s, 0, sizeof(INDEX_SRC));
+    strncpy(s->src, src, FILENAMESZ - 1);
+    if (s_prev == NULL) idx->src = s;
+    else s_prev->next = s;
+    return s;
+}
+
+/**
+ * set test id to sorted line numbers (id < 0: lines only)
+ * the runs of lines are added with one cursor, so that the ranges of
+ * the source are walked once. (20261018)
+ * 0: ok
+ * -1: error
+ */
+static int add_index_lines(TEST_INDEX *idx, INDEX_SRC *s, int *lines, int n, int id)
+{
+    INDEX_RANGE **cur = &s->range;
+    int i, j;
+
+    for (i = 0; i < n; i = j) {
+        for (j = i + 1; j < n && lines[j] == lines[j-1] + 1; j++);
+        if (add_index_range(idx, &cur, lines[i], lines[j-1], id) != 0) return -1;
+    }
+    return 0;
+}
+
+/**
+ * set test id to lines start-end (id < 0: lines only)
+ * ranges are split at start and end. the walk starts at *cur, and
+ * *cur is left at the range after end for the next (larger) start.
+ * 0: ok
+ * -1: error
+ */
+static int add_index_range(TEST_INDEX *idx, INDEX_RANGE ***cur, int start, int end, int id)
+{
+    INDEX_RANGE **pp, *r, *nr;
+    int lineno = start;
+
+    for (pp = *cur; lineno <= end; ) {
+        r = *pp;
+        if (r == NULL || lineno < r->start) {
+            /* gap: new range up to next range */
+            if ((nr = new_index_range(idx, lineno, (r && r->start - 1 < end) ? r->start - 1 : end, NULL)) == NULL) return -1;
+            nr->next = r;
+            *pp = nr;
+            r = nr;
+        } else if (r->end < lineno) {
+            pp = &r->next;
+            continue;
+        } else if (r->start < lineno) {
+            /* split head */
+            if ((nr = new_index_range(idx, lineno, r->end, r->tests)) == NULL) return -1;
+            nr->next = r->next;
+            r->next = nr;
+            r->end = lineno - 1;
+            pp = &r->next;
+            continue;
+        }
+        if (r->end > end) {
+            /* split tail */
+            if ((nr = new_index_range(idx, end + 1, r->end, r->tests)) == NULL) return -1;
+            nr->next = r->next;
+            r->next = nr;
+            r->end = end;
+        }
+        if (id >= 0) r->tests[id / 64] |= 1UL << (id % 64);
+        lineno = r->end + 1;
+        pp = &r->next;
+        *cur = pp;
+    }
+    return 0;
+}
+
+/**
+ * join neighbour ranges with the same tests (add 20261018)
+ * (split from add_index_range, called once per source)
+ */
+static void join_index_range(TEST_INDEX *idx, INDEX_SRC *s)
+{
+    INDEX_RANGE *r, *nr;
+
+    for (r = s->range; r && r->next; ) {
+        nr = r->next;
+        if (r->end + 1 == nr->start && memcmp(r->tests, nr->tests, idx->nword * sizeof(unsigned long)) == 0) {
+            r->end = nr->end;
+            r->next = nr->next;
+            free(nr->tests);
+            free(nr);
+        } else {
+            r = nr;
+        }
+    }
+}
+
+/**
+ * new index range (tests is copied, NULL: no test)
+ */
+static INDEX_RANGE *new_index_range(TEST_INDEX *idx, int start, int end, unsigned long *tests)
+{
+    INDEX_RANGE *r;
+
+    if ((r = (INDEX_RANGE *)malloc(sizeof(INDEX_RANGE))) == NULL) return NULL;
+    memset(r, 0, sizeof(INDEX_RANGE));
+    if ((r->tests = (unsigned long *)calloc(idx->nword, sizeof(unsigned long))) == NULL) { free(r); return NULL; }
+    if (tests) memcpy(r->tests, tests, idx->nword * sizeof(unsigned long));
+    r->start = start;
+    r->end = end;
+    return r;
+}
+
+/**
+ * read executed line numbers of gcov file (sorted, unique)
+ * all: 1 executable lines (not executed lines too)
+ * >=0: line count (*lines must be freed)
+ * -1: error
+ */
+static int read_gcov_executed(char *file, int **lines, int all)
+{
+    GCOV_LINE_BUF view;
+    unsigned long long s_pos, e_pos;
+    char *c;
+    int *tmp, n, max, i, j;
+
+    if (gcov_line_map(&view, file) != 0) return -1; /* 20261018 */
+    max = 256;
+    n = 0;
+    if ((*lines = (int *)malloc(max * sizeof(int))) == NULL) { gcov_line_free(&view); return -1; }
+
+    while (gcov_line_next(&view, &s_pos, &e_pos)) {
+        if (view.top[s_pos] != ' ') continue; /* function, branch, call ... */
+        if ((c = (char *)memchr(view.top + s_pos, ':', e_pos - s_pos)) == NULL) continue;
+        if (*(c-1) == '-') continue; /* not executable */
+        if (!all && !isdigit(*(c-1)) && *(c-1) != '*') continue; /* #####, ===== */
+
+        if (n == max) {
+            if ((tmp = (int *)realloc(*lines, max * 2 * sizeof(int))) == NULL) break;
+            *lines = tmp;
+            max *= 2;
+        }
+        (*lines)[n++] = gcov_line_lineno(&view, s_pos, e_pos);
+    }
+    gcov_line_free(&view);
+
+    qsort(*lines, n, sizeof(int), compare_int);
+    for (i = j = 0; i < n; i++) {
+        if (j == 0 || (*lines)[j-1] != (*lines)[i]) (*lines)[j++] = (*lines)[i];
+    }
+    return j;
+}
+
+/**
+ * qsort compare (int)
+ */
+static int compare_int(const void *a, const void *b)
+{
+    return *(const int *)a - *(const int *)b;
+}
+
+/****** shard partial result (add 20261018) ******/
+/**
+ * write partial result of one gcov data
+ * only the gcov lines of changed ranges are written, so a partial file
+ * is small enough to be moved from the shards to the merge step.
+ * format)
+ *  DIFFGCOV-PARTIAL 1
+ *  F gcov
+ *  N function record     <- functions overlapping changed lines
+ *  L gcov line           <- ex) "L         6:   10:    y += i;"
+ *  B gcov branch line    <- branches of the last L line
+ *  C gcov condition line <- conditions of the last L line
+ *  U start end           <- lines not in coverage baseline (-r)
+ */
+void dgc_write_partial(FILE *fp, GCOV_DATA *p)
+{
+    GCOV_LINE_DATA *pl;
+    GCOV_BRANCH_DATA *pb;
+    GCOV_FUNC_DATA *pf;
+    LINE_DATA *pu;
+
+    fprintf(fp, "F %s\n", p->gcov);
+    for (pf = p->func; pf; pf = pf->next) { /* 20261018 */
+        fputs("N ", fp);
+        dgc_gcov_line_print(fp, &p->linebuf, pf->s_pos, pf->e_pos);
+    }
+    for (pl = p->line; pl; pl = pl->next) {
+        fputs("L ", fp);
+        dgc_gcov_line_print(fp, &p->linebuf, pl->s_pos, pl->e_pos);
+        for (pb = pl->branch; pb; pb = pb->next) {
+            fputs("B ", fp);
+            dgc_gcov_line_print(fp, dgc_gcov_branch_buf(p, pb), pb->s_pos, pb->e_pos);
+        }
+        for (pb = pl->cond; pb; pb = pb->next) { /* 20261018 */
+            fputs("C ", fp);
+            dgc_gcov_line_print(fp, dgc_gcov_branch_buf(p, pb), pb->s_pos, pb->e_pos);
+        }
+    }
+    for (pu = p->unknown; pu; pu = pu->next) fprintf(fp, "U %d %d\n", pu->start, pu->end);
+}
+
+/**
+ * load partial file and merge it
+ * a line is executed if any shard executed it, and its count is the
+ * sum of the shards. a branch is taken if any shard took it, and so
+ * are function calls and condition outcomes.
+ * 0: ok
+ * -1: error
+ */
+int dgc_load_partial(char *file, MERGE_FILE **top)
+{
+    GCOV_LINE_BUF view;
+    char *linebuf = NULL, *tmp;
+    unsigned long long s_pos, e_pos, max = 0;
+    MERGE_FILE *f = NULL;
+    MERGE_LINE *ml = NULL;
+    int idx = 0, start, end;
+    char *c;
+
+    if (gcov_line_map(&view, file) != 0) {
+        printf("!!! %s can not open !!!\n", file);
+        return -1;
+    }
+
+    if (gcov_line_next(&view, &s_pos, &e_pos) == 0 || e_pos - s_pos != strlen(PARTIAL_MAGIC)
+        || memcmp(view.top + s_pos, PARTIAL_MAGIC, e_pos - s_pos) != 0) {
+        printf("!!! %s is not partial result !!!\n", file);
+        gcov_line_free(&view);
+        return -1;
+    }
+
+    while (gcov_line_next(&view, &s_pos, &e_pos)) { /* records are not cut (20261018) */
+        if (e_pos - s_pos < 2 || view.top[s_pos+1] != ' ') continue;
+        if (e_pos - s_pos + 1 > max) {
+            if ((tmp = (char *)realloc(linebuf, e_pos - s_pos + 1)) == NULL) break;
+            linebuf = tmp;
+            max = e_pos - s_pos + 1;
+        }
+        memcpy(linebuf, view.top + s_pos, e_pos - s_pos);
+        linebuf[e_pos - s_pos] = 0;
+
+        if ((linebuf[0] == 'F' || linebuf[0] == 'L') && ml != NULL) merge_cond_flush(ml);
+        if (linebuf[0] == 'F') {
+            if ((f = get_merge_file(top, linebuf + 2)) == NULL) break;
+            f->cur = NULL;
+            ml = NULL;
+        } else if (linebuf[0] == 'N' && f != NULL) { /* 20261018 */
+            if (merge_gcov_func(f, linebuf + 2) != 0) break;
+        } else if (linebuf[0] == 'L' && f != NULL) {
+            if (merge_gcov_line(f, linebuf + 2, &ml) != 0) break;
+            idx = 0;
+        } else if (linebuf[0] == 'B' && ml != NULL) {
+            if (merge_gcov_branch(ml, idx++, linebuf + 2) != 0) break;
+        } else if (linebuf[0] == 'C' && ml != NULL) { /* 20261018 */
+            if (merge_gcov_cond(ml, linebuf + 2) != 0) break;
+        } else if (linebuf[0] == 'U' && f != NULL) {
+            start = strtol(linebuf + 2, &c, 10);
+            end = strtol(c, &c, 10);
+            merge_unknown_line(f, start, end);
+        }
+    }
+    if (ml != NULL) merge_cond_flush(ml);
+    free(linebuf);
+    gcov_line_free(&view);
+    return 0;
+}
+
+/**
+ * merge gcov data of one object (add 20261018)
+ * the records are merged in the same way as a partial result.
+ * 0: ok
+ * -1: error
+ */
+static int merge_gcov_data(MERGE_FILE **top, GCOV_DATA *p)
+{
+    GCOV_LINE_DATA *pl;
+    GCOV_BRANCH_DATA *pb;
+    GCOV_FUNC_DATA *pf;
+    MERGE_FILE *f;
+    MERGE_LINE *ml;
+    char *line;
+    int idx, ret = 0;
+
+    if ((f = get_merge_file(top, p->gcov)) == NULL) return -1;
+    f->cur = NULL;
+    for (pf = p->func; pf && ret == 0; pf = pf->next) {
+        if ((line = gcov_line_strdup(&p->linebuf, pf->s_pos, pf->e_pos)) == NULL) return -1;
+        ret = merge_gcov_func(f, line);
+        free(line);
+    }
+    for (pl = p->line; pl && ret == 0; pl = pl->next) {
+        if ((line = gcov_line_strdup(&p->linebuf, pl->s_pos, pl->e_pos)) == NULL) return -1;
+        ret = merge_gcov_line(f, line, &ml);
+        free(line);
+        if (ml == NULL) continue;
+        for (idx = 0, pb = pl->branch; pb && ret == 0; pb = pb->next) {
+            if ((line = gcov_line_strdup(dgc_gcov_branch_buf(p, pb), pb->s_pos, pb->e_pos)) == NULL) return -1;
+            ret = merge_gcov_branch(ml, idx++, line);
+            free(line);
+        }
+        for (pb = pl->cond; pb && ret == 0; pb = pb->next) {
+            if ((line = gcov_line_strdup(dgc_gcov_branch_buf(p, pb), pb->s_pos, pb->e_pos)) == NULL) return -1;
+            ret = merge_gcov_cond(ml, line);
+            free(line);
+        }
+        merge_cond_flush(ml);
+    }
+    return ret;
+}
+
+/**
+ * get merge file by gcov name (created if not found)
+ */
+static MERGE_FILE *get_merge_file(MERGE_FILE **top, char *gcov)
+{
+    MERGE_FILE *f, *f_prev = NULL;
+
+    for (f = *top; f; f = f->next) {
+        if (strcmp(f->gcov, gcov) == 0) return f;
+        f_prev = f;
+    }
+    if ((f = (MERGE_FILE *)malloc(sizeof(MERGE_FILE))) == NULL) return NULL;
+    memset(f, 0, sizeof(MERGE_FILE));
+    strncpy(f->gcov, gcov, sizeof(f->gcov)-1);
+    if (f_prev == NULL) *top = f;
+    else f_prev->next = f;
+    return f;
+}
+
+/**
+ * get merge line by lineno (created if not found)
+ * the search starts from the last merged line, as records are sorted.
+ */
+static MERGE_LINE *get_merge_line(MERGE_FILE *f, int lineno)
+{
+    MERGE_LINE *l, *l_prev, *ml;
+
+    l_prev = NULL;
+    l = f->line;
+    if (f->cur && f->cur->lineno <= lineno) {
+        if (f->cur->lineno == lineno) return f->cur;
+        l_prev = f->cur;
+        l = f->cur->next;
+    }
+    for (; l && l->lineno < lineno; l = l->next) l_prev = l;
+    if (l && l->lineno == lineno) return l;
+
+    if ((ml = (MERGE_LINE *)malloc(sizeof(MERGE_LINE))) == NULL) return NULL;
+    memset(ml, 0, sizeof(MERGE_LINE));
+    ml->lineno = lineno;
+    ml->next = l;
+    if (l_prev == NULL) f->line = ml;
+    else l_prev->next = ml;
+    return ml;
+}
+
+/**
+ * merge one gcov line
+ * 0: ok
+ * -1: error
+ */
+static int merge_gcov_line(MERGE_FILE *f, char *line, MERGE_LINE **ml)
+{
+    char *c1, *c2;
+    int exec;
+
+    *ml = NULL;
+    if ((c1 = strchr(line, ':')) == NULL) return 0;
+    if ((c2 = strchr(c1 + 1, ':')) == NULL) return 0;
+
+    if ((*ml = get_merge_line(f, atoi(c1 + 1))) == NULL) return -1;
+    f->cur = *ml;
+    if ((*ml)->src == NULL) {
+        if (((*ml)->src = strdup(c2 + 1)) == NULL) return -1;
+    }
+    (*ml)->count += parse_gcov_count(line, &exec);
+    (*ml)->exec |= exec;
+    return 0;
+}
+
+/**
+ * merge one gcov branch line (idx: branch number of the line)
+ * 0: ok
+ * -1: error
+ */
+static int merge_gcov_branch(MERGE_LINE *ml, int idx, char *line)
+{
+    MERGE_BRANCH *b, *b_prev = NULL;
+    int pass;
+
+    for (b = ml->branch; b && idx > 0; b = b->next, idx--) b_prev = b;
+    pass = !(strstr(line, " 0%") || strstr(line, "never"));
+
+    if (b == NULL) {
+        if ((b = (MERGE_BRANCH *)malloc(sizeof(MERGE_BRANCH))) == NULL) return -1;
+        memset(b, 0, sizeof(MERGE_BRANCH));
+        if (b_prev == NULL) ml->branch = b;
+        else b_prev->next = b;
+    } else if (b->pass || !pass) {
+        return 0;
+    }
+    free(b->text);
+    if ((b->text = strdup(line)) == NULL) return -1;
+    b->pass = pass;
+    return 0;
+}
+
+/**
+ * merge one function record (add 20261018)
+ * 0: ok
+ * -1: error
+ */
+static int merge_gcov_func(MERGE_FILE *f, char *line)
+{
+    MERGE_FUNC *mf, *mf_prev = NULL;
+    char *c;
+    unsigned long long called;
+
+    if ((c = strstr(line, " called ")) == NULL) return 0;
+    for (mf = f->func; mf; mf = mf->next) {
+        if ((unsigned long)(c - line) == strlen(mf->name) && strncmp(mf->name, line, c - line) == 0) break;
+        mf_prev = mf;
+    }
+    if (mf == NULL) {
+        if ((unsigned long)(c - line) >= sizeof(mf->name)) return 0;
+        if ((mf = (MERGE_FUNC *)malloc(sizeof(MERGE_FUNC))) == NULL) return -1;
+        memset(mf, 0, sizeof(MERGE_FUNC));
+        memcpy(mf->name, line, c - line);
+        if (mf_prev == NULL) f->func = mf;
+        else mf_prev->next = mf;
+    }
+
+    called = strtoull(c + strlen(" called "), &c, 10);
+    mf->called += called;
+    if (mf->rest == NULL || called > mf->max) {
+        free(mf->rest);
+        if ((mf->rest = strdup(c)) == NULL) return -1;
+        mf->max = called;
+    }
+    return 0;
+}
+
+/**
+ * merge one condition line of current shard (add 20261018)
+ * a new block starts with "condition outcomes covered x/y", and the
+ * not covered outcomes follow. they are joined to the other shards by
+ * merge_cond_flush().
+ * 0: ok
+ * -1: error
+ */
+static int merge_gcov_cond(MERGE_LINE *ml, char *line)
+{
+    MERGE_COND *mc, *mc_prev = NULL;
+    int i, covered, total, term;
+
+    if (sscanf(line, "condition outcomes covered %d/%d", &covered, &total) == 2) {
+        for (i = 0, mc = ml->cond; mc && i < ml->ncond; mc = mc->next, i++) mc_prev = mc;
+        ml->ncond++;
+        if (mc != NULL) return 0;
+        if ((mc = (MERGE_COND *)malloc(sizeof(MERGE_COND))) == NULL) return -1;
+        memset(mc, 0, sizeof(MERGE_COND));
+        mc->nterm = total / 2;
+        mc->mask = (unsigned char *)malloc(mc->nterm + 1);
+        mc->shard = (unsigned char *)calloc(mc->nterm + 1, 1);
+        if (mc->mask == NULL || mc->shard == NULL) { free(mc->mask); free(mc->shard); free(mc); return -1; }
+        memset(mc->mask, 3, mc->nterm + 1);
+        if (mc_prev == NULL) ml->cond = mc;
+        else mc_prev->next = mc;
+        return 0;
+    }
+    if (sscanf(line, "condition %d not covered", &term) != 1 || ml->ncond == 0) return 0;
+    for (i = 1, mc = ml->cond; mc && i < ml->ncond; mc = mc->next, i++);
+    if (mc == NULL || term < 0 || term >= mc->nterm) return 0;
+    if (strstr(line, "(true")) mc->shard[term] |= 1;
+    if (strstr(line, "false)")) mc->shard[term] |= 2;
+    return 0;
+}
+
+/**
+ * join condition outcomes of current shard (add 20261018)
+ * an outcome is covered if any shard covered it.
+ * the blocks not in current shard are left as they are.
+ */
+static void merge_cond_flush(MERGE_LINE *ml)
+{
+    MERGE_COND *mc;
+    int i, n;
+
+    for (n = 0, mc = ml->cond; mc && n < ml->ncond; mc = mc->next, n++) {
+        for (i = 0; i < mc->nterm; i++) {
+            mc->mask[i] &= mc->shard[i];
+            mc->shard[i] = 0;
+        }
+    }
+    ml->ncond = 0;
+}
+
+/**
+ * merge unknown line range (same ranges of shards are merged)
+ */
+static void merge_unknown_line(MERGE_FILE *f, int start, int end)
+{
+    LINE_DATA *pu, *pu_prev = NULL;
+
+    for (pu = f->unknown; pu; pu = pu->next) {
+        if (pu->start == start && pu->end == end) return;
+        pu_prev = pu;
+    }
+    if ((pu = (LINE_DATA *)malloc(sizeof(LINE_DATA))) == NULL) return;
+    memset(pu, 0, sizeof(LINE_DATA));
+    pu->start = start;
+    pu->end = end;
+    if (pu_prev == NULL) f->unknown = pu;
+    else pu_prev->next = pu;
+}
+
+/**
+ * create gcov data from merged partial results
+ * the merged lines are written back in gcov format, so the result is
+ * calculated and printed in the same way as a .gcov file.
+ */
+GCOV_DATA *dgc_create_gcov_data_merge(MERGE_FILE *f)
+{
+    char linebuf[LINEBUFSZ];
+    char count[32];
+    GCOV_DATA *top = NULL, *p, *p_prev;
+    GCOV_LINE_DATA *pl, *pl_prev;
+    GCOV_FUNC_DATA *pf, *pf_prev;
+    MERGE_LINE *ml;
+    MERGE_BRANCH *b;
+    MERGE_FUNC *mf;
+    MERGE_COND *mc;
+    unsigned long long s_pos, e_pos;
+
+    for (; f; f = f->next) {
+        if ((p = (GCOV_DATA *)malloc(sizeof(GCOV_DATA))) == NULL) break;
+        memset(p, 0, sizeof(GCOV_DATA));
+        strcpy(p->gcov, f->gcov);
+        p->unknown = f->unknown;
+        p->line_unknown = dgc_count_line_data(f->unknown);
+
+        for (mf = f->func; mf; mf = mf->next) { /* 20261018 */
+            if (gcov_line_data_printf(&p->linebuf, &s_pos, &e_pos, "%s called %llu%s", mf->name, mf->called, mf->rest ? mf->rest : "") == 0) break;
+            if ((pf = (GCOV_FUNC_DATA *)malloc(sizeof(GCOV_FUNC_DATA))) == NULL) break;
+            memset(pf, 0, sizeof(GCOV_FUNC_DATA));
+            pf->s_pos = s_pos;
+            pf->e_pos = e_pos;
+            if (p->func == NULL) p->func = pf;
+            else pf_prev->next = pf;
+            pf_prev = pf;
+        }
+
+        for (ml = f->line; ml; ml = ml->next) {
+            if (!ml->exec) strcpy(count, "-");
+            else if (ml->count == 0) strcpy(count, "#####");
+            else snprintf(count, sizeof(count), "%llu", ml->count);
+            if (gcov_line_data_printf(&p->linebuf, &s_pos, &e_pos, "%9s:%5d:%s", count, ml->lineno, ml->src ? ml->src : "") == 0) break;
+
+            if ((pl = (GCOV_LINE_DATA *)malloc(sizeof(GCOV_LINE_DATA))) == NULL) break;
+            memset(pl, 0, sizeof(GCOV_LINE_DATA));
+            pl->s_pos = s_pos;
+            pl->e_pos = e_pos;
+            for (b = ml->branch; b; b = b->next) {
+                if (append_gcov_branch_data(&p->linebuf, &pl->branch, b->text) != 0) break;
+            }
+            for (mc = ml->cond; mc; mc = mc->next) { /* 20261018 */
+                if (append_merge_cond(&p->linebuf, &pl->cond, mc) != 0) break;
+            }
+            if (p->line == NULL) p->line = pl;
+            else pl_prev->next = pl;
+            pl_prev = pl;
+        }
+
+        if (top == NULL) top = p;
+        else p_prev->next = p;
+        p_prev = p;
+    }
+    return top;
+}
+
+/**
+ * merge data memory free
+ */
+void dgc_free_merge_data(MERGE_FILE *p)
+{
+    MERGE_FILE *p_next;
+    MERGE_LINE *l, *l_next;
+    MERGE_BRANCH *b, *b_next;
+    MERGE_FUNC *mf, *mf_next;
+
+    for (; p; p = p_next) {
+        for (l = p->line; l; l = l_next) {
+            for (b = l->branch; b; b = b_next) {
+                b_next = b->next;
+                free(b->text);
+                free(b);
+            }
+            free_merge_cond(l->cond); /* 20261018 */
+            l_next = l->next;
+            free(l->src);
+            free(l);
+        }
+        for (mf = p->func; mf; mf = mf_next) { /* 20261018 */
+            mf_next = mf->next;
+            free(mf->rest);
+            free(mf);
+        }
+        free_line_data(p->unknown);
+        p_next = p->next;
+        free(p);
+    }
+}
+
+/****** library api (add 20261018) ******/
+/**
+ * open coverage set
+ * .gcov files under dir are read on first query and stay resident
+ * until dgc_coverage_close(). they are copied to memory, so the files
+ * can be rewritten while the set is open (the set is not updated).
+ * NULL: error
+ */
+DGC_COVERAGE *dgc_coverage_open(const char *dir)
+{
+    DGC_COVERAGE *cov;
+
+    if ((cov = (DGC_COVERAGE *)malloc(sizeof(DGC_COVERAGE))) == NULL) return NULL;
+    memset(cov, 0, sizeof(DGC_COVERAGE));
+    strncpy(cov->dir, dir ? dir : ".", sizeof(cov->dir)-1);
+    pthread_mutex_init(&cov->mutex, NULL);
+    return cov;
+}
+
+/**
+ * close coverage set
+ */
+void dgc_coverage_close(DGC_COVERAGE *cov)
+{
+    COVERAGE_FILE *f, *f_next;
+    int i;
+
+    if (cov == NULL) return;
+    for (i = 0; i < COVERAGE_HASHSZ; i++) {
+        for (f = cov->file[i]; f; f = f_next) {
+            f_next = f->next;
+            gcov_line_free(&f->view);
+            free(f);
+        }
+    }
+    pthread_mutex_destroy(&cov->mutex);
+    free(cov);
+}
+
+/**
+ * query coverage of diff buffer
+ * opt NULL or opt->diff_fmt DGC_UNKNOWN_FMT: analyzed from the buffer
+ * 0: ok (result must be freed by dgc_result_free())
+ * -1: err
+ * DGC_ERR_FORMAT: unknown diff format
+ */
+int dgc_query(DGC_COVERAGE *cov, const char *diff, unsigned long sz, const DGC_QUERY_OPTION *opt, DGC_RESULT *result) /* 20261018 */
+{
+    FILE *fp;
+    int fmt = opt ? opt->diff_fmt : DGC_UNKNOWN_FMT;
+    DIFF_DATA *d, *top = NULL;
+    GCOV_DATA gcov;
+    COVERAGE_FILE *f;
+    int i, err, ret = 0;
+
+    memset(result, 0, sizeof(DGC_RESULT));
+    if (cov == NULL || diff == NULL || sz == 0) return -1;
+
+    if ((fp = fmemopen((void *)diff, sz, "r")) == NULL) return -1;
+    if (fmt == DGC_UNKNOWN_FMT) {
+        fmt = get_diff_format_fp(fp);
+        rewind(fp);
+    }
+    if (fmt == DGC_UNKNOWN_FMT) { fclose(fp); return DGC_ERR_FORMAT; }
+    create_diff_data_fp(fp, fmt, &top);
+    fclose(fp);
+
+    for (d = top; d; d = d->next) result->nfile++;
+    if (result->nfile > 0 && (result->file = (DGC_FILE_RESULT *)calloc(result->nfile, sizeof(DGC_FILE_RESULT))) == NULL) {
+        dgc_free_diff_data(top);
+        result->nfile = 0;
+        return -1;
+    }
+
+    for (i = 0, d = top; d; d = d->next, i++) {
+        strcpy(result->file[i].src, d->src);
+        if ((f = get_coverage_file(cov, d->src, &err)) == NULL) {
+            if (err) { ret = -1; break; }
+            continue; /* not found */
+        }
+        if (f->err || f->view.pos == 0) continue;
+
+        memset(&gcov, 0, sizeof(gcov));
+        gcov.linebuf = f->view; /* shared buffer, own refpos (20261018) */
+        create_gcov_line_data(&gcov, d->line);
+        dgc_parcent(&gcov);
+        ret = create_query_result(&gcov, &result->file[i], result);
+        gcov_line_free(&gcov.joined);
+        free_gcov_line_data(gcov.line);
+        free_gcov_func_data(gcov.func);
+        if (ret != 0) break;
+    }
+    dgc_free_diff_data(top);
+    if (ret != 0) dgc_result_free(result);
+    return ret;
+}
+
+/**
+ * query result memory free
+ */
+void dgc_result_free(DGC_RESULT *result)
+{
+    int i;
+
+    for (i = 0; i < result->nfile; i++) free(result->file[i].line);
+    free(result->file);
+    memset(result, 0, sizeof(DGC_RESULT));
+}
+
+/**
+ * load all .gcov files of coverage set at once (add 20261018)
+ * the files under dir are mapped by io_batch and copied, so that no
+ * query pays for the first read. the files made later are still read
+ * on query. opt->jobs files are read at once (opt NULL: 1).
+ * 0: ok
+ * -1: error
+ */
+int dgc_coverage_load(DGC_COVERAGE *cov, const DGC_QUERY_OPTION *opt) /* 20261018 */
+{
+    int jobs = (opt && opt->jobs > 0) ? opt->jobs : 1;
+    IO_BATCH batch;
+    IO_REQ *req;
+    COVERAGE_FILE *nf;
+    char **names = NULL;
+    int i, n = 0, max = 0;
+
+    if (cov == NULL) return -1;
+    if (list_dir_files(cov->dir, "", ".gcov", &names, &n, &max) != 0) {
+        for (i = 0; i < n; i++) free(names[i]);
+        free(names);
+        return -1;
+    }
+    if ((req = (IO_REQ *)calloc(n ? n : 1, sizeof(IO_REQ))) == NULL) {
+        for (i = 0; i < n; i++) free(names[i]);
+        free(names);
+        return -1;
+    }
+    for (i = 0; i < n; i++) {
+        snprintf(req[i].path, sizeof(req[i].path), "%s/%s", cov->dir, names[i]);
+        req[i].flags = IO_MAP;
+    }
+    io_batch_submit(&batch, req, n, jobs);
+
+    for (i = 0; i < n; i++) {
+        io_batch_wait(&batch, i);
+        if ((nf = (COVERAGE_FILE *)malloc(sizeof(COVERAGE_FILE))) != NULL) {
+            memset(nf, 0, sizeof(COVERAGE_FILE));
+            strcpy(nf->gcov, names[i]);
+            nf->err = req[i].err != 0 || gcov_line_dup(&nf->view, req[i].buf, req[i].sz) != 0;
+            insert_coverage_file(cov, nf);
+        }
+        io_batch_release(&batch, i);
+        free(names[i]);
+    }
+    io_batch_finish(&batch);
+    free(req);
+    free(names);
+    return 0;
+}
+
+/**
+ * list files of ext under dir (add 20261018)
+ * rel: sub directory of dir ("" top), names are relative to dir.
+ * ex) dir "build", ext ".gcov" -> "foo.c.gcov", "src/bar.c.gcov"
+ * 0: ok
+ * -1: error
+ */
+static int list_dir_files(char *dir, const char *rel, const char *ext, char ***names, int *n, int *max)
+{
+    char path[FILENAMESZ * 2];
+    char name[FILENAMESZ];
+    DIR *dp;
+    struct dirent *de;
+    struct stat st;
+    char **tmp;
+    int len, ret = 0;
+
+    snprintf(path, sizeof(path), "%s/%s", dir, rel);
+    if ((dp = opendir(path)) == NULL) return rel[0] ? 0 : -1;
+    while ((de = readdir(dp)) != NULL) {
+        if (de->d_name[0] == '.') continue;
+        if (snprintf(name, sizeof(name), "%s%s%s", rel, rel[0] ? "/" : "", de->d_name) >= (int)sizeof(name)) continue;
+        len = strlen(name);
+        snprintf(path, sizeof(path), "%s/%s", dir, name);
+        if (de->d_type == DT_DIR || (de->d_type == DT_UNKNOWN && stat(path, &st) == 0 && S_ISDIR(st.st_mode))) {
+            if ((ret = list_dir_files(dir, name, ext, names, n, max)) != 0) break;
+            continue;
+        }
+        if (len <= (int)strlen(ext) || strcmp(name + len - strlen(ext), ext) != 0) continue;
+        if (*n == *max) {
+            if ((tmp = (char **)realloc(*names, (*max ? *max * 2 : 256) * sizeof(char *))) == NULL) { ret = -1; break; }
+            *names = tmp;
+            *max = *max ? *max * 2 : 256;
+        }
+        if (((*names)[*n] = strdup(name)) == NULL) { ret = -1; break; }
+        (*n)++;
+    }
+    closedir(dp);
+    return ret;
+}
+
+/**
+ * get coverage file of source (read and cached, if not yet)
+ * a missing .gcov is not cached, so that names sent to the server do
+ * not grow the table. a source out of dir ("/..", "../..") is not read.
+ * NULL: not found (*err 0) or error (*err 1)
+ */
+static COVERAGE_FILE *get_coverage_file(DGC_COVERAGE *cov, char *src, int *err)
+{
+    char gcov[FILENAMESZ];
+    char path[FILENAMESZ * 2];
+    GCOV_LINE_BUF view;
+    COVERAGE_FILE *f, *nf;
+    unsigned int h;
+
+    *err = 0;
+    if (!is_safe_src(src)) return NULL;
+    snprintf(gcov, sizeof(gcov), "%s.gcov", src);
+    h = hash_name(gcov) % COVERAGE_HASHSZ;
+
+    pthread_mutex_lock(&cov->mutex);
+    for (f = cov->file[h]; f; f = f->next) {
+        if (strcmp(f->gcov, gcov) == 0) break;
+    }
+    pthread_mutex_unlock(&cov->mutex);
+    if (f) return f;
+
+    /* read without lock, the first one inserted is used */
+    snprintf(path, sizeof(path), "%s/%s", cov->dir, gcov);
+    if (gcov_line_map(&view, path) != 0) return NULL;
+    if ((nf = (COVERAGE_FILE *)malloc(sizeof(COVERAGE_FILE))) == NULL) {
+        gcov_line_free(&view);
+        *err = 1;
+        return NULL;
+    }
+    memset(nf, 0, sizeof(COVERAGE_FILE));
+    strcpy(nf->gcov, gcov);
+    nf->err = gcov_line_dup(&nf->view, view.top, view.pos) != 0;
+    gcov_line_free(&view);
+    return insert_coverage_file(cov, nf);
+}
+
+/**
+ * check source name in coverage set dir (add 20261018)
+ * 1: relative path without ".." (ex "src/foo.c")
+ * 0: absolute path, or ".." in path
+ */
+static int is_safe_src(char *src)
+{
+    char *c;
+
+    if (src[0] == '\0' || src[0] == '/') return 0;
+    for (c = src; (c = strstr(c, "..")) != NULL; c += 2) {
+        if ((c == src || c[-1] == '/') && (c[2] == '\0' || c[2] == '/')) return 0;
+    }
+    return 1;
+}
+
+/**
+ * insert coverage file to table (split from get_coverage_file 20261018)
+ * nf is freed if the same file is already inserted.
+ */
+static COVERAGE_FILE *insert_coverage_file(DGC_COVERAGE *cov, COVERAGE_FILE *nf)
+{
+    COVERAGE_FILE *f;
+    unsigned int h;
+
+    h = hash_name(nf->gcov) % COVERAGE_HASHSZ;
+    pthread_mutex_lock(&cov->mutex);
+    for (f = cov->file[h]; f; f = f->next) {
+        if (strcmp(f->gcov, nf->gcov) == 0) break;
+    }
+    if (f == NULL) {
+        nf->next = cov->file[h];
+        cov->file[h] = nf;
+        f = nf;
+        nf = NULL;
+    }
+    pthread_mutex_unlock(&cov->mutex);
+    if (nf) {
+        gcov_line_free(&nf->view);
+        free(nf);
+    }
+    return f;
+}
+
+/**
+ * hash of file name
+ */
+static unsigned int hash_name(char *name)
+{
+    unsigned int h = 5381;
+
+    for (; *name; name++) h = h * 33 + (unsigned char)*name;
+    return h;
+}
+
+/**
+ * create query result of one file (r: result of the file)
+ * 0: ok
+ * -1: error
+ */
+static int create_query_result(GCOV_DATA *gcov, DGC_FILE_RESULT *r, DGC_RESULT *result)
+{
+    char linebuf[LINEBUFSZ];
+    GCOV_LINE_DATA *pl;
+    char *c;
+    int n;
+
+    r->found = 1;
+    r->line_parcent = gcov->line_parcent;
+    r->branch_parcent = gcov->branch_parcent;
+    r->line_pass = gcov->line_pass;
+    r->line_notpass = gcov->line_notpass;
+    r->branch_pass = gcov->branch_pass;
+    r->branch_notpass = gcov->branch_notpass;
+    result->line_pass += gcov->line_pass;
+    result->line_notpass += gcov->line_notpass;
+    result->branch_pass += gcov->branch_pass;
+    result->branch_notpass += gcov->branch_notpass;
+    r->func_pass = gcov->func_pass; /* 20261018 */
+    r->func_notpass = gcov->func_notpass;
+    r->cond_pass = gcov->cond_pass;
+    r->cond_notpass = gcov->cond_notpass;
+    result->func_pass += gcov->func_pass;
+    result->func_notpass += gcov->func_notpass;
+    result->cond_pass += gcov->cond_pass;
+    result->cond_notpass += gcov->cond_notpass;
+
+    for (n = 0, pl = gcov->line; pl; pl = pl->next) n++;
+    if (n == 0) return 0;
+    if ((r->line = (DGC_LINE_RESULT *)calloc(n, sizeof(DGC_LINE_RESULT))) == NULL) return -1;
+    for (pl = gcov->line; pl; pl = pl->next) {
+        memset(linebuf, 0, sizeof(linebuf));
+        if (dgc_gcov_line_get_by_pos(&gcov->linebuf, linebuf, sizeof(linebuf)-1, pl->s_pos, pl->e_pos) == 0) break;
+        if ((c = strchr(linebuf, ':')) == NULL) continue;
+        r->line[r->nline].lineno = atoi(c + 1);
+        r->line[r->nline].exec = pl->exec;
+        r->line[r->nline].count = pl->count;
+        r->line[r->nline].branch_pass = pl->branch_pass;
+        r->line[r->nline].branch_notpass = pl->branch_notpass;
+        r->line[r->nline].cond_pass = pl->cond_pass;
+        r->line[r->nline].cond_total = pl->cond_total;
+        r->nline++;
+    }
+    return 0;
+}
+
+/**
+ * merge condition memory free (add 20261018)
+ */
+static void free_merge_cond(MERGE_COND *p)
+{
+    MERGE_COND *p_next;
+
+    for (; p; p = p_next) {
+        p_next = p->next;
+        free(p->mask);
+        free(p->shard);
+        free(p);
+    }
+}
+
+/****** coverage query server (add 20261018) ******/
+/**
+ * run query server on unix domain socket
+ * the coverage set of dir is loaded once, and the diffs sent to sock
+ * are answered by jobs threads. SIGHUP or "RELOAD" loads the coverage
+ * set again, and the queries in flight finish with the old one.
+ * SIGINT, SIGTERM stop the server.
+ * the socket is made 0600, so only its owner can query or reload.
+ * request)
+ *  diff text, then shutdown(SHUT_WR)
+ *  RELOAD   <- load coverage set again
+ * response) see write_query_result()
+ * 0: ok
+ * -1: error
+ */
+int dgc_server(const char *sock, const char *dir, int jobs)
+{
+    SERVER s;
+    struct sockaddr_un addr;
+    struct pollfd pfd[2];
+    struct signalfd_siginfo si;
+    sigset_t mask, oldmask;
+    int i, fd, sfd, ret = 0;
+
+    memset(&s, 0, sizeof(s));
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(sock) >= sizeof(addr.sun_path) || strlen(dir) >= sizeof(s.dir)) return -1;
+    strcpy(addr.sun_path, sock);
+    strcpy(s.dir, dir);
+    s.qopt.diff_fmt = DGC_UNKNOWN_FMT;
+    s.qopt.jobs = jobs;
+    pthread_mutex_init(&s.mutex, NULL);
+    pthread_cond_init(&s.cond, NULL);
+
+    if ((s.cur = server_coverage_open(s.dir, &s.qopt)) == NULL) {
+        printf("!!! %s can not load !!!\n", dir);
+        ret = -1;
+    } else if ((s.fd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
+        ret = -1;
+    } else {
+        unlink(sock);
+        if (bind(s.fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 || chmod(sock, 0600) < 0 /* owner only, before listen */
+            || listen(s.fd, SERVER_BACKLOG) < 0) {
+            printf("!!! %s can not listen !!!\n", sock);
+            close(s.fd);
+            ret = -1;
+        }
+    }
+    if (ret != 0) {
+        if (s.cur) server_coverage_put(&s, s.cur);
+        pthread_cond_destroy(&s.cond);
+        pthread_mutex_destroy(&s.mutex);
+        return -1;
+    }
+
+    /* signals are blocked in all threads, and read from signalfd */
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGHUP);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &mask, &oldmask);
+    if ((sfd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC)) < 0) ret = -1;
+
+    if ((s.th = (pthread_t *)calloc(jobs, sizeof(pthread_t))) != NULL) {
+        for (i = 0; i < jobs; i++) {
+            if (pthread_create(&s.th[i], NULL, server_worker, &s) != 0) break;
+        }
+        s.nthread = i;
+    }
+    if (s.nthread == 0) ret = -1;
+    else if (ret == 0) printf("diffgcov server %s (%s, %d threads)\n", sock, dir, s.nthread);
+    fflush(stdout);
+
+    pfd[0].fd = s.fd;
+    pfd[0].events = POLLIN;
+    pfd[1].fd = sfd;
+    pfd[1].events = POLLIN;
+    while (ret == 0) {
+        if (poll(pfd, 2, -1) < 0) {
+            if (errno == EINTR) continue;
+            ret = -1;
+            break;
+        }
+        while (read(sfd, &si, sizeof(si)) == (ssize_t)sizeof(si)) {
+            if (si.ssi_signo == SIGHUP) server_reload(&s);
+            else s.stop = 1;
+        }
+        if (s.stop) break;
+        if (!(pfd[0].revents & POLLIN)) continue;
+        if ((fd = accept(s.fd, NULL, NULL)) < 0) continue;
+
+        pthread_mutex_lock(&s.mutex);
+        while (s.nqueue == SERVER_QUEUESZ) pthread_cond_wait(&s.cond, &s.mutex);
+        s.queue[(s.qhead + s.nqueue) % SERVER_QUEUESZ] = fd;
+        s.nqueue++;
+        pthread_cond_broadcast(&s.cond);
+        pthread_mutex_unlock(&s.mutex);
+    }
+
+    /* the accepted connections are answered before stop */
+    pthread_mutex_lock(&s.mutex);
+    s.stop = 1;
+    pthread_cond_broadcast(&s.cond);
+    pthread_mutex_unlock(&s.mutex);
+    for (i = 0; i < s.nthread; i++) pthread_join(s.th[i], NULL);
+    free(s.th);
+    if (sfd >= 0) close(sfd);
+    pthread_sigmask(SIG_SETMASK, &oldmask, NULL);
+
+    close(s.fd);
+    unlink(sock);
+    server_coverage_put(&s, s.cur);
+    pthread_cond_destroy(&s.cond);
+    pthread_mutex_destroy(&s.mutex);
+    return ret;
+}
+
+/**
+ * server thread pool worker
+ */
+static void *server_worker(void *arg)
+{
+    SERVER *s = (SERVER *)arg;
+    int fd;
+
+    while (1) {
+        pthread_mutex_lock(&s->mutex);
+        while (s->nqueue == 0 && !s->stop) pthread_cond_wait(&s->cond, &s->mutex);
+        if (s->nqueue == 0) {
+            pthread_mutex_unlock(&s->mutex);
+            break;
+        }
+        fd = s->queue[s->qhead];
+        s->qhead = (s->qhead + 1) % SERVER_QUEUESZ;
+        s->nqueue--;
+        pthread_cond_broadcast(&s->cond);
+        pthread_mutex_unlock(&s->mutex);
+
+        server_request(s, fd);
+    }
+    return NULL;
+}
+
+/**
+ * answer one connection (fd is closed)
+ * the response is made in memory and sent with MSG_NOSIGNAL, so a
+ * client gone away gets no SIGPIPE to the process.
+ */
+static void server_request(SERVER *s, int fd)
+{
+    SERVER_COVERAGE *sc;
+    DGC_RESULT result;
+    struct timeval tv;
+    FILE *fp;
+    char *buf = NULL, *tmp, *out = NULL;
+    unsigned long sz = 0, max = 0;
+    size_t outsz = 0, pos;
+    ssize_t len;
+    int ret, err = 0;
+
+    tv.tv_sec = SERVER_TIMEOUT;
+    tv.tv_usec = 0;
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    while (1) { /* until client shutdown */
+        if (sz == max) {
+            if (max >= SERVER_REQUEST_MAX) { err = 1; break; }
+            if ((tmp = (char *)realloc(buf, max ? max * 2 : 64 * 1024)) == NULL) { err = 2; break; }
+            buf = tmp;
+            max = max ? max * 2 : 64 * 1024;
+        }
+        if ((len = read(fd, buf + sz, max - sz)) < 0 && errno == EINTR) continue;
+        if (len < 0) { err = 2; break; }
+        if (len == 0) break;
+        sz += len;
+    }
+    if ((fp = open_memstream(&out, &outsz)) == NULL) {
+        close(fd);
+        free(buf);
+        return;
+    }
+
+    fprintf(fp, "%s\n", RESULT_MAGIC);
+    if (err) {
+        fprintf(fp, "E -1 %s\n", err == 1 ? "request too large" : "request not read");
+    } else if (sz >= 6 && memcmp(buf, "RELOAD", 6) == 0 && (sz == 6 || buf[6] == '\n')) {
+        fprintf(fp, "R %d\n", server_reload(s));
+    } else {
+        sc = server_coverage_get(s);
+        ret = dgc_query(sc->cov, buf, sz, &s->qopt, &result);
+        server_coverage_put(s, sc);
+        if (ret == 0) {
+            write_query_result(fp, &result);
+            dgc_result_free(&result);
+        } else {
+            fprintf(fp, "E %d %s\n", ret, ret == DGC_ERR_FORMAT ? "unknown diff format" : "query error");
+        }
+    }
+    fclose(fp);
+    for (pos = 0; out && pos < outsz; pos += len) {
+        if ((len = send(fd, out + pos, outsz - pos, MSG_NOSIGNAL)) < 0) {
+            if (errno == EINTR) { len = 0; continue; }
+            break;
+        }
+    }
+    close(fd);
+    free(out);
+    free(buf);
+}
+
+/**
+ * write query result
+ * format)
+ *  DIFFGCOV-RESULT 1
+ *  F src found line_pass line_notpass branch_pass branch_notpass func_pass func_notpass cond_pass cond_notpass
+ *    (src is escaped by write_escaped_name(), ex) "my file.c" -> "my%20file.c")
+ *  L lineno exec count branch_pass branch_notpass cond_pass cond_total  <- changed lines of the last F
+ *  T line_pass line_notpass branch_pass branch_notpass func_pass func_notpass cond_pass cond_notpass
+ *  E code message  <- error (instead of F, L, T)
+ *  R code          <- RELOAD (0: ok, -1: error)
+ */
+static void write_query_result(FILE *fp, DGC_RESULT *result)
+{
+    DGC_FILE_RESULT *r;
+    DGC_LINE_RESULT *l;
+    int i, j;
+
+    for (i = 0; i < result->nfile; i++) {
+        r = &result->file[i];
+        fputs("F ", fp);
+        write_escaped_name(fp, r->src);
+        fprintf(fp, " %d %d %d %d %d %d %d %d %d\n", r->found, r->line_pass, r->line_notpass,
+            r->branch_pass, r->branch_notpass, r->func_pass, r->func_notpass, r->cond_pass, r->cond_notpass);
+        for (j = 0; j < r->nline; j++) {
+            l = &r->line[j];
+            fprintf(fp, "L %d %d %llu %d %d %d %d\n", l->lineno, l->exec, l->count,
+                l->branch_pass, l->branch_notpass, l->cond_pass, l->cond_total);
+        }
+    }
+    fprintf(fp, "T %d %d %d %d %d %d %d %d\n", result->line_pass, result->line_notpass, result->branch_pass,
+        result->branch_notpass, result->func_pass, result->func_notpass, result->cond_pass, result->cond_notpass);
+}
+
+/**
+ * write name as one field of a result line (add 20261018)
+ * space, control, non-ASCII and '%' bytes are written as %XX, so a
+ * name from the diff can not break the line or add a record.
+ */
+static void write_escaped_name(FILE *fp, char *name)
+{
+    unsigned char *c;
+
+    for (c = (unsigned char *)name; *c; c++) {
+        if (*c <= ' ' || *c >= 0x7f || *c == '%') fprintf(fp, "%%%02X", *c);
+        else fputc(*c, fp);
+    }
+}
+
+/**
+ * load coverage set again and swap it
+ * the old set is closed when its last query finishes.
+ * 0: ok
+ * -1: error (old set is kept)
+ */
+static int server_reload(SERVER *s)
+{
+    SERVER_COVERAGE *sc, *old;
+
+    if ((sc = server_coverage_open(s->dir, &s->qopt)) == NULL) return -1;
+    pthread_mutex_lock(&s->mutex);
+    old = s->cur;
+    s->cur = sc;
+    pthread_mutex_unlock(&s->mutex);
+    server_coverage_put(s, old);
+    printf("diffgcov server reload %s\n", s->dir);
+    fflush(stdout);
+    return 0;
+}
+
+/**
+ * open and load coverage set (ref 1: held by server)
+ * NULL: error
+ */
+static SERVER_COVERAGE *server_coverage_open(char *dir, const DGC_QUERY_OPTION *opt)
+{
+    SERVER_COVERAGE *sc;
+
+    if ((sc = (SERVER_COVERAGE *)malloc(sizeof(SERVER_COVERAGE))) == NULL) return NULL;
+    memset(sc, 0, sizeof(SERVER_COVERAGE));
+    if ((sc->cov = dgc_coverage_open(dir)) == NULL || dgc_coverage_load(sc->cov, opt) != 0) {
+        dgc_coverage_close(sc->cov);
+        free(sc);
+        return NULL;
+    }
+    sc->ref = 1;
+    return sc;
+}
+
+/**
+ * get current coverage set for a query
+ */
+static SERVER_COVERAGE *server_coverage_get(SERVER *s)
+{
+    SERVER_COVERAGE *sc;
+
+    pthread_mutex_lock(&s->mutex);
+    sc = s->cur;
+    sc->ref++;
+    pthread_mutex_unlock(&s->mutex);
+    return sc;
+}
+
+/**
+ * release coverage set (closed by the last one)
+ */
+static void server_coverage_put(SERVER *s, SERVER_COVERAGE *sc)
+{
+    int ref;
+
+    pthread_mutex_lock(&s->mutex);
+    ref = --sc->ref;
+    pthread_mutex_unlock(&s->mutex);
+    if (ref > 0) return;
+    dgc_coverage_close(sc->cov);
+    free(sc);
+}
@@ -0,0 +1,118 @@
+/**
+ * libdiffgcov : gcov lines checker library
+ * (author murata.muu@gmail.com)
+ * 2026.10.18 diffgcov から分離
+ *            coverage set を常駐させ, diff バッファ単位で問い合わせる API
+ *            dgc_coverage_load() で coverage set を一括ロード (--server)
+ *            command の option, report は diffgcov に残し, 公開は問い合わせ option のみ
+ *
+ * usage)
+ *  DGC_COVERAGE *cov = dgc_coverage_open("build");  <- dir of .gcov files
+ *  DGC_QUERY_OPTION opt = { DGC_UNKNOWN_FMT, 4 };   <- or NULL (format detected, 1 job)
+ *  dgc_coverage_load(cov, &opt);                    <- optional, reads all at once
+ *  DGC_RESULT result;
+ *  dgc_query(cov, diff, diff_sz, &opt, &result);
+ *  ... result.file[i].line_pass ...
+ *  dgc_result_free(&result);
+ *  dgc_coverage_close(cov);
+ *
+ * the functions have no global state. dgc_query() can be called from
+ * many threads on the same coverage set. (dgc_server() blocks SIGHUP,
+ * SIGINT and SIGTERM in the calling thread while it runs.)
+ */
+#ifndef LIBDIFFGCOV_H
+#define LIBDIFFGCOV_H
+
+#define DGC_FILENAMESZ 256
+#define DGC_ERR_FORMAT -2       /* unknown diff format */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum _dgc_diff_fmt {    /* DGC_ prefix 20261018 */
+    DGC_UNKNOWN_FMT, /* 20100531 */
+    DGC_CVS_FMT,
+    DGC_DIFF_FMT,
+    DGC_SVN_FMT,     /* 20100531 */
+    DGC_GIT_FMT,     /* 20261018 */
+};
+
+enum _dgc_gcov_level { /* 20110210, DGC_ prefix 20261018 */
+    DGC_UNKNOWN_LEVEL,
+    DGC_C0_LINE_LEVEL,
+    DGC_C1_BRANCH_LEVEL,
+    DGC_ALL_LEVEL,   /* line, branch, function, condition (20261018) */
+};
+
+/**
+ * query option (dgc_query, dgc_coverage_load)
+ */
+struct _dgc_query_option {
+    int diff_fmt;             /* DGC_UNKNOWN_FMT: detected from the diff */
+    int jobs;                 /* .gcov files read at once by dgc_coverage_load() */
+};
+typedef struct _dgc_query_option DGC_QUERY_OPTION; /* 20261018 */
+
+/**
+ * query result
+ */
+struct _dgc_line_result {
+    int lineno;
+    int exec;                 /* executable line */
+    unsigned long long count; /* execution count */
+    int branch_pass;
+    int branch_notpass;
+    int cond_pass;            /* covered condition outcomes */
+    int cond_total;
+};
+typedef struct _dgc_line_result DGC_LINE_RESULT;
+
+struct _dgc_file_result {
+    char src[DGC_FILENAMESZ];
+    int found;                /* .gcov is in coverage set */
+    double line_parcent;
+    double branch_parcent;
+    int line_pass;
+    int line_notpass;
+    int branch_pass;
+    int branch_notpass;
+    int func_pass;            /* functions overlapping changed lines */
+    int func_notpass;
+    int cond_pass;
+    int cond_notpass;
+    int nline;
+    DGC_LINE_RESULT *line;    /* changed lines in .gcov */
+};
+typedef struct _dgc_file_result DGC_FILE_RESULT;
+
+struct _dgc_result {
+    int nfile;
+    DGC_FILE_RESULT *file;    /* in diff order */
+    int line_pass;            /* total */
+    int line_notpass;
+    int branch_pass;
+    int branch_notpass;
+    int func_pass;
+    int func_notpass;
+    int cond_pass;
+    int cond_notpass;
+};
+typedef struct _dgc_result DGC_RESULT;
+
+typedef struct _dgc_coverage DGC_COVERAGE; /* loaded coverage set */
+
+/**
+ * library function
+ */
+DGC_COVERAGE *dgc_coverage_open(const char *dir);
+int dgc_coverage_load(DGC_COVERAGE *cov, const DGC_QUERY_OPTION *opt);
+void dgc_coverage_close(DGC_COVERAGE *cov);
+int dgc_query(DGC_COVERAGE *cov, const char *diff, unsigned long sz, const DGC_QUERY_OPTION *opt, DGC_RESULT *result);
+void dgc_result_free(DGC_RESULT *result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBDIFFGCOV_H */
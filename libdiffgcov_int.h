@@ -0,0 +1,183 @@
+/**
+ * libdiffgcov internal : diffgcov command と libdiffgcov の間の内部 interface
+ * (author murata.muu@gmail.com)
+ * 2026.10.18 new (install しない, diffgcov.c のみが使う)
+ *            diff, gcov data の構造と dgc_* 内部関数
+ *            stream モードは1ファイルごとに report callback を呼ぶ
+ */
+#ifndef LIBDIFFGCOV_INT_H
+#define LIBDIFFGCOV_INT_H
+
+#include <stdio.h>
+#include "libdiffgcov.h"
+
+#define LINEBUFSZ 1024
+#define FILENAMESZ DGC_FILENAMESZ
+#define GCOV_COMMAND "/usr/bin/gcov"
+#define PARTIAL_MAGIC "DIFFGCOV-PARTIAL 1"  /* --partial result file */
+#define STAMP_FILENAME ".diffgcov.stamp"    /* --stamp gcda content stamps */
+
+/**
+ * structure define
+ */
+
+struct _line_data {
+    int start;
+    int end;
+    struct _line_data *next;
+};
+typedef struct _line_data LINE_DATA;
+
+struct _diff_data {
+    char src[FILENAMESZ];
+    LINE_DATA *line;
+    LINE_DATA *unknown; /* -r: new lines not in coverage baseline (20261018) */
+    struct _diff_data *next;
+};
+typedef struct _diff_data DIFF_DATA;
+
+struct _gcov_line_buf {
+    char *top;
+    unsigned long long max;
+    unsigned long long pos;
+    unsigned long long refpos;
+    int mapped;               /* top is mmap of .gcov file (20261018) */
+};
+typedef struct _gcov_line_buf GCOV_LINE_BUF; /* 20100531 */
+
+struct _gcov_branch_data {
+    unsigned long long s_pos; /* 20261018 */
+    unsigned long long e_pos;
+    int taken; /* taken %, -1: never executed (20261018) */
+    int joined;                   /* record is in GCOV_DATA joined (20261018) */
+    int ninst;                    /* template instances of the record */
+    unsigned long long taken_sum; /* sum of taken % x line count of instances */
+    unsigned long long count_sum; /* sum of line count of instances */
+    struct _gcov_branch_data *next;
+};
+typedef struct _gcov_branch_data GCOV_BRANCH_DATA; /* 20110210 */
+
+struct _gcov_func_data {
+    unsigned long long s_pos;
+    unsigned long long e_pos;
+    struct _gcov_func_data *next;
+};
+typedef struct _gcov_func_data GCOV_FUNC_DATA; /* 20261018 */
+
+struct _gcov_inst_data {
+    unsigned long long name_s; /* instance name ("_Z3addIiET_S0_S0_") */
+    unsigned long long name_e;
+    unsigned long long s_pos;  /* line in instance block */
+    unsigned long long e_pos;
+    int branch_pass;
+    int branch_notpass;
+    struct _gcov_inst_data *next;
+};
+typedef struct _gcov_inst_data GCOV_INST_DATA; /* 20261018 */
+
+struct _gcov_line_data {
+    unsigned long long s_pos; /* 20261018 */
+    unsigned long long e_pos;
+    int lineno;               /* 20261018 */
+    GCOV_BRANCH_DATA *branch;
+    int branch_pass;
+    int branch_notpass;
+    GCOV_BRANCH_DATA *cond;   /* condition lines (20261018) */
+    int cond_pass;            /* covered condition outcomes */
+    int cond_total;
+    int exec;                 /* executable line (20261018) */
+    unsigned long long count; /* execution count (20261018) */
+    GCOV_INST_DATA *inst;     /* template instances (20261018) */
+    struct _merge_line *join; /* conditions of instances (20261018) */
+    struct _gcov_line_data *next;
+};
+typedef struct _gcov_line_data GCOV_LINE_DATA; /* 20110210 */
+
+struct _gcov_data {
+    char gcov[FILENAMESZ];
+    GCOV_LINE_BUF linebuf;
+    GCOV_LINE_BUF joined; /* records joined over template instances (20261018) */
+    GCOV_LINE_DATA *line; /* 20110210 */
+    double line_parcent;
+    double branch_parcent; /* 20110210 */
+    int line_pass;
+    int line_notpass;
+    int branch_pass; /* 20110210 */
+    int branch_notpass;
+    int line_unknown;   /* 20261018 */
+    LINE_DATA *unknown; /* refers DIFF_DATA */
+    GCOV_FUNC_DATA *func; /* functions overlapping changed lines (20261018) */
+    double func_parcent;
+    double cond_parcent;
+    int func_pass;
+    int func_notpass;
+    int cond_pass;
+    int cond_notpass;
+    struct _gcov_data *next;
+};
+typedef struct _gcov_data GCOV_DATA;
+
+struct _index_range {
+    int start;
+    int end;
+    unsigned long *tests;     /* bitmap of test id (nword words) */
+    struct _index_range *next;
+};
+typedef struct _index_range INDEX_RANGE; /* 20261018 */
+
+struct _index_src {
+    char src[FILENAMESZ];
+    INDEX_RANGE *range;       /* sorted, not overlapped */
+    struct _index_src *next;
+};
+typedef struct _index_src INDEX_SRC; /* 20261018 */
+
+struct _test_index {
+    int ntest;
+    int nword;
+    char (*test)[FILENAMESZ]; /* test name by id */
+    INDEX_SRC *src;
+};
+typedef struct _test_index TEST_INDEX; /* 20261018 */
+
+typedef struct _merge_file MERGE_FILE; /* --merge: records summed over partial files */
+
+struct _gcov_stream {
+    void (*report)(void *arg, GCOV_DATA *p); /* called once per gcov data */
+    void *arg;
+    GCOV_DATA *top;           /* reported data (counters only) */
+    GCOV_DATA *last;
+};
+typedef struct _gcov_stream GCOV_STREAM; /* 20261018 */
+
+/**
+ * internal function (libdiffgcov.c)
+ */
+int dgc_get_diff_format(char *filename);
+void dgc_create_diff_data(char *file, int fmt, int jobs, DIFF_DATA **top);
+int dgc_remap_diff_data(DIFF_DATA *diff, char *file);
+int dgc_count_line_data(LINE_DATA *p);
+void dgc_free_diff_data(DIFF_DATA *p);
+int dgc_need_gcov_update(DIFF_DATA *diff, int jobs, int stamp);
+int dgc_save_gcda_stamp_dir(char *file, int jobs);
+void dgc_create_gcov_data(DIFF_DATA *diff, GCOV_DATA **top, int jobs, GCOV_STREAM *stream);
+int dgc_create_gcov_data_pipe(DIFF_DATA *diff, GCOV_DATA **top, int level, int jobs, GCOV_STREAM *stream);
+void dgc_free_gcov_data(GCOV_DATA *p);
+void dgc_parcent(GCOV_DATA *p);
+void dgc_gcov_line_print(FILE *fp, GCOV_LINE_BUF *p, unsigned long long s_pos, unsigned long long e_pos);
+int dgc_gcov_line_get_by_pos(GCOV_LINE_BUF *p, char *out, unsigned long outsz, unsigned long long s_pos, unsigned long long e_pos);
+unsigned long long dgc_gcov_func_called(GCOV_LINE_BUF *buf, GCOV_FUNC_DATA *pf);
+GCOV_LINE_BUF *dgc_gcov_branch_buf(GCOV_DATA *p, GCOV_BRANCH_DATA *pb);
+int dgc_gcov_has_conditions(void);
+int dgc_load_test_index(char *file, TEST_INDEX *idx);
+int dgc_save_test_index(char *file, TEST_INDEX *idx);
+void dgc_free_test_index(TEST_INDEX *idx);
+int dgc_add_test_index(TEST_INDEX *idx, char *test, char *dir);
+INDEX_SRC *dgc_get_index_src(TEST_INDEX *idx, char *src, int create);
+void dgc_write_partial(FILE *fp, GCOV_DATA *p);
+int dgc_load_partial(char *file, MERGE_FILE **top);
+GCOV_DATA *dgc_create_gcov_data_merge(MERGE_FILE *f);
+void dgc_free_merge_data(MERGE_FILE *p);
+int dgc_server(const char *sock, const char *dir, int jobs);
+
+#endif /* LIBDIFFGCOV_INT_H */